@@ -22,4 +22,10 @@
 #define NTW_SYSCALL(fn) fn
 #endif
 
-#define NTW_IMPORT_CALL(fn) fn
\ No newline at end of file
+#define NTW_IMPORT_CALL(fn) fn
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define NTW_SSE2 1
+#else
+#define NTW_SSE2 0
+#endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "common.hpp"
+#include "../vm/allocation.hpp"
+#include "../vm/operation.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace ntw::detail {
+
+    /// \brief Owning byte buffer backed by virtual memory which only ever grows.
+    /// \note Allocation failures are reported as status codes, nothing throws.
+    class growable_buffer {
+        std::uint8_t* _data = nullptr;
+        std::size_t   _size = 0;
+
+    public:
+        /// \brief Constructs an empty buffer without allocating.
+        NTW_INLINE constexpr growable_buffer() noexcept = default;
+
+        NTW_INLINE ~growable_buffer() noexcept;
+
+        NTW_INLINE growable_buffer(growable_buffer&& other) noexcept;
+
+        NTW_INLINE growable_buffer& operator=(growable_buffer&& other) noexcept;
+
+        /// \brief Makes sure the buffer is at least size bytes large.
+        /// \param size The minimum required size in bytes.
+        /// \param preserve Whether the old contents are copied into the new buffer.
+        /// \note The buffer grows at least by a factor of 2 to amortize reallocation.
+        NTW_INLINE status reserve(std::size_t size, bool preserve = false) noexcept;
+
+        /// \brief Frees the owned memory.
+        NTW_INLINE void reset() noexcept;
+
+        /// \brief Returns the beginning of buffer.
+        NTW_INLINE std::uint8_t* data() const noexcept { return _data; }
+
+        /// \brief Returns the size of buffer in bytes.
+        NTW_INLINE std::size_t size() const noexcept { return _size; }
+
+        /// \brief Returns the beginning of buffer.
+        NTW_INLINE std::uint8_t* begin() const noexcept { return _data; }
+
+        /// \brief Returns one past the end of buffer.
+        NTW_INLINE std::uint8_t* end() const noexcept { return _data + _size; }
+
+        /// \brief Returns a span over the whole buffer.
+        NTW_INLINE byte_span span() const noexcept { return { _data, _size }; }
+
+        /// \brief Returns the buffer reinterpreted as an array of T.
+        template<class T>
+        NTW_INLINE T* as() const noexcept
+        {
+            return reinterpret_cast<T*>(_data);
+        }
+    };
+
+    /// \brief Checks whether the status signals that the supplied buffer was too small.
+    NTW_INLINE constexpr bool is_size_mismatch(status s) noexcept
+    {
+        return s == STATUS_INFO_LENGTH_MISMATCH || s == STATUS_BUFFER_TOO_SMALL ||
+               s == STATUS_BUFFER_OVERFLOW;
+    }
+
+    /// \brief Calls query(buffer, &returned) until the result fits into the buffer.
+    /// \param buffer The buffer that will be grown when needed.
+    /// \param initial_size The size to use if the buffer was never allocated.
+    /// \param query Callable which returns the status of query and the required size.
+    /// \note The required size may change between calls so 1/8 of slack is added.
+    template<class Query>
+    NTW_INLINE status query_growing(growable_buffer& buffer,
+                                    std::size_t      initial_size,
+                                    Query            query) noexcept
+    {
+        if(!buffer.size()) {
+            if(const auto s = buffer.reserve(initial_size); !s.success())
+                return s;
+        }
+
+        while(true) {
+            ulong_t    returned = 0;
+            const auto s        = query(buffer, &returned);
+            if(!is_size_mismatch(s))
+                return s;
+
+            // the buffer has to grow even if the returned size already fits into it
+            const auto required = std::max<std::size_t>(returned, buffer.size() + 1);
+            if(const auto rs = buffer.reserve(required + required / 8); !rs.success())
+                return rs;
+        }
+    }
+
+    NTW_INLINE growable_buffer::~growable_buffer() noexcept { reset(); }
+
+    NTW_INLINE growable_buffer::growable_buffer(growable_buffer&& other) noexcept
+        : _data(other._data), _size(other._size)
+    {
+        other._data = nullptr;
+        other._size = 0;
+    }
+
+    NTW_INLINE growable_buffer& growable_buffer::operator=(growable_buffer&& other) noexcept
+    {
+        const auto data = other._data;
+        const auto size = other._size;
+        other._data     = _data;
+        other._size     = _size;
+        _data           = data;
+        _size           = size;
+        return *this;
+    }
+
+    NTW_INLINE status growable_buffer::reserve(std::size_t size, bool preserve) noexcept
+    {
+        if(size <= _size)
+            return STATUS_SUCCESS;
+
+        if(size < _size * 2)
+            size = _size * 2;
+
+        const auto res = vm::allocate().commit_reserve(size);
+        if(!res)
+            return res.status();
+
+        const auto new_data = static_cast<std::uint8_t*>(*res);
+        if(preserve && _size)
+            std::memcpy(new_data, _data, _size);
+
+        reset();
+        _data = new_data;
+        _size = size;
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE void growable_buffer::reset() noexcept
+    {
+        if(_data)
+            static_cast<void>(vm::release(_data));
+        _data = nullptr;
+        _size = 0;
+    }
+
+} // namespace ntw::detail
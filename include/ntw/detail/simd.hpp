@@ -0,0 +1,203 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "config.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+
+#if NTW_SSE2
+#include <emmintrin.h>
+#endif
+
+// SSE2 is part of the x64 baseline so no runtime dispatch is needed for these kernels.
+// Other architectures use the scalar fallbacks.
+namespace ntw::detail::simd {
+
+    /// \brief Returns the sum of all values.
+    NTW_INLINE std::uint64_t sum(const std::uint64_t* values, std::size_t count) noexcept
+    {
+        std::uint64_t total = 0;
+        std::size_t   i     = 0;
+#if NTW_SSE2
+        auto acc0 = _mm_setzero_si128();
+        auto acc1 = _mm_setzero_si128();
+        for(; i + 4 <= count; i += 4) {
+            const auto p = reinterpret_cast<const __m128i*>(values + i);
+            acc0         = _mm_add_epi64(acc0, _mm_loadu_si128(p));
+            acc1         = _mm_add_epi64(acc1, _mm_loadu_si128(p + 1));
+        }
+
+        alignas(16) std::uint64_t lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(acc0, acc1));
+        total = lanes[0] + lanes[1];
+#endif
+        for(; i < count; ++i)
+            total += values[i];
+        return total;
+    }
+
+    /// \brief Returns the sum of all values widened to 64 bits.
+    NTW_INLINE std::uint64_t sum(const std::uint32_t* values, std::size_t count) noexcept
+    {
+        std::uint64_t total = 0;
+        std::size_t   i     = 0;
+#if NTW_SSE2
+        const auto zero = _mm_setzero_si128();
+        auto       acc  = _mm_setzero_si128();
+        for(; i + 4 <= count; i += 4) {
+            const auto v =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, zero));
+            acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, zero));
+        }
+
+        alignas(16) std::uint64_t lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        total = lanes[0] + lanes[1];
+#endif
+        for(; i < count; ++i)
+            total += values[i];
+        return total;
+    }
+
+    /// \brief Returns the sum of values[i] where keys[i] == key.
+    NTW_INLINE std::uint64_t sum_where(const std::uint64_t* values,
+                                       const std::uint32_t* keys,
+                                       std::uint32_t        key,
+                                       std::size_t          count) noexcept
+    {
+        std::uint64_t total = 0;
+        std::size_t   i     = 0;
+#if NTW_SSE2
+        const auto needle = _mm_set1_epi32(static_cast<int>(key));
+        auto       acc    = _mm_setzero_si128();
+        for(; i + 4 <= count; i += 4) {
+            const auto k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+            const auto m = _mm_cmpeq_epi32(k, needle);
+            const auto p = reinterpret_cast<const __m128i*>(values + i);
+            // widen the 32 bit lane masks to 64 bits
+            acc = _mm_add_epi64(
+                acc, _mm_and_si128(_mm_loadu_si128(p), _mm_unpacklo_epi32(m, m)));
+            acc = _mm_add_epi64(
+                acc, _mm_and_si128(_mm_loadu_si128(p + 1), _mm_unpackhi_epi32(m, m)));
+        }
+
+        alignas(16) std::uint64_t lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        total = lanes[0] + lanes[1];
+#endif
+        for(; i < count; ++i)
+            if(keys[i] == key)
+                total += values[i];
+        return total;
+    }
+
+    /// \brief Returns the length of a null terminated string or max if no terminator is
+    ///        found within the first max characters.
+    /// \note Never reads past str + max.
+    NTW_INLINE std::size_t string_length(const char* str, std::size_t max) noexcept
+    {
+        std::size_t i = 0;
+#if NTW_SSE2
+        const auto zero = _mm_setzero_si128();
+        for(; i + 16 <= max; i += 16) {
+            const auto v    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+            const auto mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, zero));
+            if(mask)
+                return i + std::countr_zero(static_cast<std::uint32_t>(mask));
+        }
+#endif
+        for(; i < max; ++i)
+            if(!str[i])
+                return i;
+        return max;
+    }
+
+    /// \brief Checks whether (value & masks[i]) == values[i] for any i.
+    NTW_INLINE bool any_masked_equal(std::uint32_t        value,
+                                     const std::uint32_t* values,
+                                     const std::uint32_t* masks,
+                                     std::size_t          count) noexcept
+    {
+        std::size_t i = 0;
+#if NTW_SSE2
+        const auto v = _mm_set1_epi32(static_cast<int>(value));
+        for(; i + 4 <= count; i += 4) {
+            const auto m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + i));
+            const auto p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            if(_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(v, m), p)))
+                return true;
+        }
+#endif
+        for(; i < count; ++i)
+            if((value & masks[i]) == values[i])
+                return true;
+        return false;
+    }
+
+    /// \brief Returns a bitmask where bit j is set if (lanes[j] & masks[i]) == values[i]
+    ///        for any i.
+    /// \param lanes The 4 values to test.
+    NTW_INLINE std::uint32_t any_masked_equal4(const std::uint32_t* lanes,
+                                               const std::uint32_t* values,
+                                               const std::uint32_t* masks,
+                                               std::size_t          count) noexcept
+    {
+#if NTW_SSE2
+        const auto v   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+        auto       acc = _mm_setzero_si128();
+        for(std::size_t i = 0; i < count; ++i) {
+            const auto m = _mm_set1_epi32(static_cast<int>(masks[i]));
+            const auto p = _mm_set1_epi32(static_cast<int>(values[i]));
+            acc          = _mm_or_si128(acc, _mm_cmpeq_epi32(_mm_and_si128(v, m), p));
+        }
+        return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(acc)));
+#else
+        std::uint32_t result = 0;
+        for(std::size_t j = 0; j < 4; ++j)
+            for(std::size_t i = 0; i < count; ++i)
+                if((lanes[j] & masks[i]) == values[i])
+                    result |= 1u << j;
+        return result;
+#endif
+    }
+
+    /// \brief Returns a 16 bit mask where bit i is set if first[i] == a and
+    ///        second[i] == b.
+    /// \note Reads exactly 16 bytes from both pointers.
+    NTW_INLINE std::uint32_t equal_pair16(const std::uint8_t* first,
+                                          std::uint8_t        a,
+                                          const std::uint8_t* second,
+                                          std::uint8_t        b) noexcept
+    {
+#if NTW_SSE2
+        const auto x  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const auto y  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second));
+        const auto mx = _mm_cmpeq_epi8(x, _mm_set1_epi8(static_cast<char>(a)));
+        const auto my = _mm_cmpeq_epi8(y, _mm_set1_epi8(static_cast<char>(b)));
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(mx, my)));
+#else
+        std::uint32_t result = 0;
+        for(std::size_t i = 0; i < 16; ++i)
+            if(first[i] == a && second[i] == b)
+                result |= 1u << i;
+        return result;
+#endif
+    }
+
+} // namespace ntw::detail::simd
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../offset_index.hpp"
+
+namespace ntw {
+
+    template<class T>
+    template<class Range>
+    NTW_INLINE status offset_index<T>::assign(Range&& range) noexcept
+    {
+        _size = 0;
+
+        auto        ptrs     = _buffer.as<pointer>();
+        std::size_t capacity = _buffer.size() / sizeof(pointer);
+        for(auto& entry : range) {
+            if(_size == capacity) {
+                const auto new_capacity = capacity ? capacity * 2 : 256;
+                const auto s = _buffer.reserve(new_capacity * sizeof(pointer), true);
+                if(!s.success()) {
+                    _size = 0;
+                    return s;
+                }
+
+                ptrs     = _buffer.as<pointer>();
+                capacity = _buffer.size() / sizeof(pointer);
+            }
+
+            ptrs[_size++] = &entry;
+        }
+
+        return STATUS_SUCCESS;
+    }
+
+    template<class T>
+    NTW_INLINE std::size_t offset_index<T>::size() const noexcept
+    {
+        return _size;
+    }
+
+    template<class T>
+    NTW_INLINE bool offset_index<T>::empty() const noexcept
+    {
+        return !_size;
+    }
+
+    template<class T>
+    NTW_INLINE const T& offset_index<T>::operator[](std::size_t idx) const noexcept
+    {
+        return *_buffer.as<pointer>()[idx];
+    }
+
+    template<class T>
+    NTW_INLINE detail::indirect_iterator<const T> offset_index<T>::begin() const noexcept
+    {
+        return iterator{ _buffer.as<pointer>() };
+    }
+
+    template<class T>
+    NTW_INLINE detail::indirect_iterator<const T> offset_index<T>::end() const noexcept
+    {
+        return iterator{ _buffer.as<pointer>() + _size };
+    }
+
+    template<class T>
+    NTW_INLINE std::span<T*> offset_index<T>::pointers() const noexcept
+    {
+        return { _buffer.as<pointer>(), _size };
+    }
+
+    template<class T>
+    template<class Key>
+    NTW_INLINE void offset_index<T>::sort_by(Key key) noexcept
+    {
+        std::sort(_buffer.as<pointer>(),
+                  _buffer.as<pointer>() + _size,
+                  [&key](pointer lhs, pointer rhs) { return key(*lhs) < key(*rhs); });
+    }
+
+    template<class T>
+    template<class Value, class Key>
+    NTW_INLINE T* offset_index<T>::find(const Value& value, Key key) const noexcept
+    {
+        const auto first = _buffer.as<pointer>();
+        const auto last  = first + _size;
+        const auto it    = std::lower_bound(
+            first, last, value, [&key](pointer lhs, const Value& rhs) {
+                return key(*lhs) < rhs;
+            });
+
+        if(it != last && !(value < key(**it)))
+            return *it;
+        return nullptr;
+    }
+
+} // namespace ntw
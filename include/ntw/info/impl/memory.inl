@@ -41,4 +41,47 @@ namespace ntw::memory {
 
     static_assert(sizeof(basic_info) == sizeof(MEMORY_BASIC_INFORMATION));
 
+    NTW_INLINE bool working_set_ex_info::is_valid() const noexcept
+    {
+        return attributes & 1;
+    }
+
+    NTW_INLINE std::uint32_t working_set_ex_info::share_count() const noexcept
+    {
+        return (attributes >> 1) & 0x7;
+    }
+
+    NTW_INLINE vm::protection working_set_ex_info::protection() const noexcept
+    {
+        return static_cast<std::uint32_t>((attributes >> 4) & 0x7FF);
+    }
+
+    NTW_INLINE bool working_set_ex_info::is_shared() const noexcept
+    {
+        return (attributes >> 15) & 1;
+    }
+
+    NTW_INLINE std::uint32_t working_set_ex_info::node() const noexcept
+    {
+        return (attributes >> 16) & 0x3F;
+    }
+
+    NTW_INLINE bool working_set_ex_info::is_locked() const noexcept
+    {
+        return (attributes >> 22) & 1;
+    }
+
+    NTW_INLINE bool working_set_ex_info::is_large_page() const noexcept
+    {
+        return (attributes >> 23) & 1;
+    }
+
+    NTW_INLINE bool working_set_ex_info::is_bad() const noexcept
+    {
+        return (attributes >> 31) & 1;
+    }
+
+    static_assert(sizeof(working_set_ex_info) ==
+                  sizeof(MEMORY_WORKING_SET_EX_INFORMATION));
+
 } // namespace ntw::memory
\ No newline at end of file
@@ -54,6 +54,42 @@ namespace ntw::memory {
         NTW_INLINE bool is_image() const noexcept;
     };
 
+    /// \brief Working set attributes of a single page. virtual_address selects the page
+    ///        and the query fills in the attributes.
+    /// \note Only is_valid and is_shared are meaningful for pages that are not valid.
+    struct working_set_ex_info {
+        std::uintptr_t virtual_address;
+        std::uintptr_t attributes;
+
+        constexpr static MEMORY_INFORMATION_CLASS info_class =
+            MemoryWorkingSetExInformation;
+        using native_type = MEMORY_WORKING_SET_EX_INFORMATION;
+
+        /// \brief Checks whether the page is resident in the working set.
+        NTW_INLINE bool is_valid() const noexcept;
+
+        /// \brief Returns the amount of processes sharing the page, saturated at 7.
+        NTW_INLINE std::uint32_t share_count() const noexcept;
+
+        /// \brief Returns the protection of the page.
+        NTW_INLINE vm::protection protection() const noexcept;
+
+        /// \brief Checks whether the page can be shared.
+        NTW_INLINE bool is_shared() const noexcept;
+
+        /// \brief Returns the NUMA node of the physical page.
+        NTW_INLINE std::uint32_t node() const noexcept;
+
+        /// \brief Checks whether the page is locked in memory.
+        NTW_INLINE bool is_locked() const noexcept;
+
+        /// \brief Checks whether the page is a part of a large page.
+        NTW_INLINE bool is_large_page() const noexcept;
+
+        /// \brief Checks whether the page has a hardware error.
+        NTW_INLINE bool is_bad() const noexcept;
+    };
+
 } // namespace ntw::memory
 
 #include "impl/memory.inl"
\ No newline at end of file
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "operation.hpp"
+#include "traits/file.hpp"
+#include "../detail/common.hpp"
+
+namespace ntw::io {
+
+    /// \brief A file API where reads and writes return as soon as they are issued.
+    ///        Any amount of requests can be in flight on the same handle, each with
+    ///        its own operation.
+    template<class Handle, class Traits = traits::async_file_traits<Handle>>
+    struct basic_async_file : detail::base_file<basic_async_file<Handle, Traits>, Traits>,
+                              Handle {
+        using handle_type = Handle;
+        using handle_type::handle_type;
+        using handle_type::operator=;
+
+        NTW_INLINE basic_async_file() = default;
+
+        /// \brief Starts reading data from file using NtReadFile API.
+        /// \param buffer The buffer into which the data will be read. Must stay valid
+        ///        until the operation completes.
+        /// \param offset The offset from the beggining of file to read data from.
+        /// \param op The operation that receives the result.
+        /// \return Returns STATUS_PENDING if the request is in flight. Any other status
+        ///         means it has already completed, successfully or not.
+        NTW_INLINE status read_async(byte_span    buffer,
+                                     std::int64_t offset,
+                                     operation&   op) const noexcept;
+
+        /// \brief Starts writing data to file using NtWriteFile API.
+        /// \param buffer The data that will be written to the file. Must stay valid
+        ///        until the operation completes.
+        /// \param offset The offset from the beggining of file to write data to.
+        /// \param op The operation that receives the result.
+        /// \return Returns STATUS_PENDING if the request is in flight. Any other status
+        ///         means it has already completed, successfully or not.
+        NTW_INLINE status write_async(cbyte_span   buffer,
+                                      std::int64_t offset,
+                                      operation&   op) const noexcept;
+
+        /// \brief Cancels the request of op using NtCancelIoFileEx API.
+        /// \note The operation still completes, usually with STATUS_CANCELLED.
+        NTW_INLINE status cancel(operation& op) const noexcept;
+
+        /// \brief Cancels every request issued on the file by any thread.
+        NTW_INLINE status cancel() const noexcept;
+    };
+
+    using async_file     = basic_async_file<ob::object>;
+    using async_file_ref = basic_async_file<ob::object_ref>;
+
+} // namespace ntw::io
+
+#include "impl/async_file.inl"
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../async_file.hpp"
+
+namespace ntw::io {
+
+    template<class Handle, class Traits>
+    NTW_INLINE status basic_async_file<Handle, Traits>::read_async(
+        byte_span buffer, std::int64_t offset, operation& op) const noexcept
+    {
+        // the offset is captured when the request is issued so it can live on stack
+        LARGE_INTEGER li_offset;
+        li_offset.QuadPart = offset;
+
+        op._begin();
+        return op._issued(
+            NTW_SYSCALL(NtReadFile)(this->get(),
+                                    ::ntw::detail::unwrap(op._event),
+                                    op._callback ? &operation::_complete : nullptr,
+                                    &op,
+                                    &op._status_block,
+                                    buffer.data(),
+                                    buffer.size(),
+                                    &li_offset,
+                                    nullptr));
+    }
+
+    template<class Handle, class Traits>
+    NTW_INLINE status basic_async_file<Handle, Traits>::write_async(
+        cbyte_span buffer, std::int64_t offset, operation& op) const noexcept
+    {
+        LARGE_INTEGER li_offset;
+        li_offset.QuadPart = offset;
+
+        op._begin();
+        return op._issued(
+            NTW_SYSCALL(NtWriteFile)(this->get(),
+                                     ::ntw::detail::unwrap(op._event),
+                                     op._callback ? &operation::_complete : nullptr,
+                                     &op,
+                                     &op._status_block,
+                                     const_cast<std::uint8_t*>(buffer.data()),
+                                     buffer.size(),
+                                     &li_offset,
+                                     nullptr));
+    }
+
+    template<class Handle, class Traits>
+    NTW_INLINE status
+               basic_async_file<Handle, Traits>::cancel(operation& op) const noexcept
+    {
+        IO_STATUS_BLOCK status_block;
+        return NTW_SYSCALL(NtCancelIoFileEx)(
+            this->get(), &op._status_block, &status_block);
+    }
+
+    template<class Handle, class Traits>
+    NTW_INLINE status basic_async_file<Handle, Traits>::cancel() const noexcept
+    {
+        IO_STATUS_BLOCK status_block;
+        return NTW_SYSCALL(NtCancelIoFileEx)(this->get(), nullptr, &status_block);
+    }
+
+} // namespace ntw::io
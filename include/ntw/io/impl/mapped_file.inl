@@ -0,0 +1,196 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../mapped_file.hpp"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace ntw::io {
+
+    namespace detail {
+
+        /// \brief Maps [offset, offset + length) of the file starting the view at the
+        ///        granularity aligned offset below it.
+        NTW_INLINE result<file_view> map_file_range(const ob::section& section,
+                                                    std::uint64_t      offset,
+                                                    std::size_t        length) noexcept
+        {
+            const auto start = offset & ~std::uint64_t{ file_view::granularity - 1 };
+            const auto lead  = static_cast<std::size_t>(offset - start);
+            if(length > std::numeric_limits<std::size_t>::max() - lead)
+                return { STATUS_INVALID_PARAMETER };
+
+            auto view = section.map(lead + length, start, vm::protection::read());
+            if(!view)
+                return { view.status() };
+
+            return { STATUS_SUCCESS, file_view{ std::move(*view), offset, length } };
+        }
+
+    } // namespace detail
+
+    NTW_INLINE file_view::file_view(ob::section_view view,
+                                    std::uint64_t    offset,
+                                    std::size_t      size) noexcept
+        : _view(std::move(view))
+        , _data(_view.data() + (offset & (granularity - 1)))
+        , _size(size)
+        , _offset(offset)
+    {}
+
+    NTW_INLINE file_view::file_view(file_view&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    NTW_INLINE file_view& file_view::operator=(file_view&& other) noexcept
+    {
+        std::swap(_view, other._view);
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        std::swap(_offset, other._offset);
+        return *this;
+    }
+
+    NTW_INLINE status file_view::unmap() noexcept
+    {
+        _data   = nullptr;
+        _size   = 0;
+        _offset = 0;
+        return _view.unmap();
+    }
+
+    NTW_INLINE const std::uint8_t* file_view::data() const noexcept { return _data; }
+
+    NTW_INLINE std::size_t file_view::size() const noexcept { return _size; }
+
+    NTW_INLINE std::uint64_t file_view::offset() const noexcept { return _offset; }
+
+    NTW_INLINE std::span<const std::uint8_t> file_view::span() const noexcept
+    {
+        return { _data, _size };
+    }
+
+    NTW_INLINE const std::uint8_t* file_view::begin() const noexcept { return _data; }
+
+    NTW_INLINE const std::uint8_t* file_view::end() const noexcept
+    {
+        return _data + _size;
+    }
+
+    NTW_INLINE const std::uint8_t& file_view::operator[](std::size_t idx) const noexcept
+    {
+        return _data[idx];
+    }
+
+    NTW_INLINE bool file_view::empty() const noexcept { return _size == 0; }
+
+    NTW_INLINE file_view::operator bool() const noexcept { return _data != nullptr; }
+
+    template<class File>
+    NTW_INLINE result<file_view>
+    map_view(const File& file, std::uint64_t offset, std::size_t length) noexcept
+    {
+        const auto size = file.size();
+        if(!size)
+            return { size.status() };
+        if(offset > *size || length > *size - offset)
+            return { STATUS_END_OF_FILE };
+
+        if(!length) {
+            if(*size - offset > std::numeric_limits<std::size_t>::max())
+                return { STATUS_INVALID_PARAMETER };
+            // empty files can't be mapped
+            length = static_cast<std::size_t>(*size - offset);
+            if(!length)
+                return { STATUS_SUCCESS, file_view{} };
+        }
+
+        const auto section = ob::section::create_from_file(file);
+        if(!section)
+            return { section.status() };
+
+        // the view keeps the section alive
+        return detail::map_file_range(*section, offset, length);
+    }
+
+    template<class File>
+    NTW_INLINE status mapped_file::open(const File& file, std::size_t window) noexcept
+    {
+        const auto size = file.size();
+        if(!size)
+            return size.status();
+
+        ob::section section;
+        if(*size) {
+            auto res = ob::section::create_from_file(file);
+            if(!res)
+                return res.status();
+            section = std::move(*res);
+        }
+
+        static_cast<void>(_view.unmap());
+        _section = std::move(section);
+        _size    = *size;
+
+        window  = std::min(window, std::numeric_limits<std::size_t>::max() / 2);
+        window  = std::max(window, file_view::granularity);
+        _window = (window + file_view::granularity - 1) & ~(file_view::granularity - 1);
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE result<std::span<const std::uint8_t>>
+               mapped_file::view(std::uint64_t offset, std::size_t length) noexcept
+    {
+        if(offset > _size || length > _size - offset)
+            return { STATUS_END_OF_FILE };
+        if(!length)
+            return { STATUS_SUCCESS, std::span<const std::uint8_t>{} };
+
+        if(!_view || offset < _view.offset() ||
+           offset + length > _view.offset() + _view.size()) {
+            const auto start = offset & ~std::uint64_t{ file_view::granularity - 1 };
+            const auto size = std::min<std::uint64_t>(
+                std::max<std::uint64_t>(offset - start + length, _window),
+                _size - start);
+
+            // the old window is gone before the new one is mapped to keep the address
+            // space usage at a single window
+            static_cast<void>(_view.unmap());
+            auto view = detail::map_file_range(
+                _section, start, static_cast<std::size_t>(size));
+            if(!view)
+                return { view.status() };
+            _view = std::move(*view);
+        }
+
+        return { STATUS_SUCCESS,
+                 std::span<const std::uint8_t>{
+                     _view.data() + static_cast<std::size_t>(offset - _view.offset()),
+                     length } };
+    }
+
+    NTW_INLINE status mapped_file::unmap() noexcept { return _view.unmap(); }
+
+    NTW_INLINE std::uint64_t mapped_file::size() const noexcept { return _size; }
+
+    NTW_INLINE std::size_t mapped_file::window() const noexcept { return _window; }
+
+    NTW_INLINE const file_view& mapped_file::current() const noexcept { return _view; }
+
+} // namespace ntw::io
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../operation.hpp"
+#include <atomic>
+#include <utility>
+
+namespace ntw::io {
+
+    NTW_INLINE void NTAPI operation::_complete(void* context,
+                                               IO_STATUS_BLOCK*,
+                                               ULONG) noexcept
+    {
+        auto& op = *static_cast<operation*>(context);
+        op._callback(op);
+    }
+
+    NTW_INLINE void operation::_begin() noexcept
+    {
+        _status_block.Status      = STATUS_PENDING;
+        _status_block.Information = 0;
+    }
+
+    NTW_INLINE ntw::status operation::_issued(ntw::status s) noexcept
+    {
+        // requests that fail right away are never completed by the system, so the
+        // result is stored here for waits and polls to see it
+        if(!s.success()) {
+            _status_block.Status = s.get();
+            if(_event)
+                static_cast<void>(_event.set());
+        }
+        return s;
+    }
+
+    NTW_INLINE operation::operation(ob::event event) noexcept : _event(std::move(event))
+    {}
+
+    NTW_INLINE operation::operation(callback_type callback, void* context) noexcept
+        : _callback(callback), _context(context)
+    {}
+
+    NTW_INLINE bool operation::pending() const noexcept
+    {
+        return status() == STATUS_PENDING;
+    }
+
+    NTW_INLINE ntw::status operation::status() const noexcept
+    {
+        // written by the system behind our back
+        const ntw::status s =
+            static_cast<const volatile IO_STATUS_BLOCK&>(_status_block).Status;
+        if(!(s == STATUS_PENDING))
+            std::atomic_thread_fence(std::memory_order_acquire);
+        return s;
+    }
+
+    NTW_INLINE std::size_t operation::transferred() const noexcept
+    {
+        return static_cast<std::size_t>(
+            static_cast<const volatile IO_STATUS_BLOCK&>(_status_block).Information);
+    }
+
+    NTW_INLINE void* operation::context() const noexcept { return _context; }
+
+    NTW_INLINE const ob::event& operation::event() const noexcept { return _event; }
+
+    NTW_INLINE ntw::status operation::wait() const noexcept
+    {
+        const auto s = _event.wait();
+        if(!s.success())
+            return s;
+        return status();
+    }
+
+    NTW_INLINE ntw::status operation::wait_for(duration timeout) const noexcept
+    {
+        const auto s = _event.wait_for(timeout);
+        if(!s.success() || s == STATUS_TIMEOUT)
+            return s;
+        return status();
+    }
+
+} // namespace ntw::io
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../ob/section.hpp"
+#include <span>
+
+namespace ntw::io {
+
+    /// \brief Read only view of a part of a file that is unmapped when it goes out of
+    ///        scope. Pages are read in by the memory manager as they are touched, so
+    ///        the data is never copied into an intermediate buffer.
+    class file_view {
+        ob::section_view    _view;
+        const std::uint8_t* _data   = nullptr;
+        std::size_t         _size   = 0;
+        std::uint64_t       _offset = 0;
+
+    public:
+        /// \brief The granularity at which views of a file can be mapped.
+        constexpr static std::size_t granularity = 0x10000;
+
+        NTW_INLINE file_view() noexcept = default;
+
+        /// \brief Takes ownership of a view that contains [offset, offset + size) of the
+        ///        file and starts at the granularity aligned offset below it.
+        NTW_INLINE file_view(ob::section_view view,
+                             std::uint64_t    offset,
+                             std::size_t      size) noexcept;
+
+        NTW_INLINE file_view(file_view&& other) noexcept;
+
+        NTW_INLINE file_view& operator=(file_view&& other) noexcept;
+
+        /// \brief Unmaps the view now instead of at scope exit.
+        NTW_INLINE status unmap() noexcept;
+
+        /// \brief Returns the data at the requested offset of the file.
+        NTW_INLINE const std::uint8_t* data() const noexcept;
+
+        /// \brief Returns the size of the requested part of the file.
+        NTW_INLINE std::size_t size() const noexcept;
+
+        /// \brief Returns the offset in the file that data points to.
+        NTW_INLINE std::uint64_t offset() const noexcept;
+
+        /// \brief Returns the requested part of the file as a span.
+        NTW_INLINE std::span<const std::uint8_t> span() const noexcept;
+
+        NTW_INLINE const std::uint8_t* begin() const noexcept;
+        NTW_INLINE const std::uint8_t* end() const noexcept;
+
+        NTW_INLINE const std::uint8_t& operator[](std::size_t idx) const noexcept;
+
+        NTW_INLINE bool empty() const noexcept;
+
+        /// \brief Checks whether a view is mapped.
+        NTW_INLINE explicit operator bool() const noexcept;
+    };
+
+    /// \brief Maps a read only view of a part of a file.
+    /// \param file The file, such as basic_file. Needs read data access.
+    /// \param offset The offset in the file. Does not need to be aligned.
+    /// \param length The amount of bytes to map. 0 maps everything past offset.
+    /// \returns STATUS_END_OF_FILE if the range does not lie within the file.
+    template<class File>
+    NTW_INLINE result<file_view>
+    map_view(const File& file, std::uint64_t offset = 0, std::size_t length = 0) noexcept;
+
+    /// \brief Read only file mapping that keeps a single window of the file mapped
+    ///        at a time, so files larger than the available address space can be
+    ///        walked through. The window only moves when a range outside of it is
+    ///        requested.
+    ///
+    /// mapped_file mapping;
+    /// mapping.open(file);
+    /// for(std::uint64_t offset = 0; offset < mapping.size(); offset += record) {
+    ///     auto data = mapping.view(offset, record);
+    ///     parse(*data);
+    /// }
+    /// \note Spans returned by view are invalidated when the window moves.
+    class mapped_file {
+        ob::section   _section;
+        std::uint64_t _size   = 0;
+        std::size_t   _window = 0;
+        file_view     _view;
+
+    public:
+        /// \brief The window size used by default.
+        constexpr static std::size_t default_window = 0x4000000;
+
+        NTW_INLINE mapped_file() noexcept = default;
+
+        /// \brief Creates a section for the file. Nothing is mapped until view is called.
+        /// \param file The file, such as basic_file. Needs read data access.
+        /// \param window The minimum amount of the file to map at once, rounded up to
+        ///        file_view::granularity.
+        template<class File>
+        NTW_INLINE status open(const File& file,
+                               std::size_t window = default_window) noexcept;
+
+        /// \brief Returns [offset, offset + length) of the file, moving the window if
+        ///        the range is not within it.
+        /// \note A range larger than the window is mapped as a whole.
+        /// \returns STATUS_END_OF_FILE if the range does not lie within the file.
+        NTW_INLINE result<std::span<const std::uint8_t>>
+                   view(std::uint64_t offset, std::size_t length) noexcept;
+
+        /// \brief Unmaps the current window.
+        NTW_INLINE status unmap() noexcept;
+
+        /// \brief Returns the size of the file at the time it was opened.
+        NTW_INLINE std::uint64_t size() const noexcept;
+
+        /// \brief Returns the size of the window.
+        NTW_INLINE std::size_t window() const noexcept;
+
+        /// \brief Returns the currently mapped window.
+        NTW_INLINE const file_view& current() const noexcept;
+    };
+
+} // namespace ntw::io
+
+#include "impl/mapped_file.inl"
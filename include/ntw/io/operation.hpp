@@ -0,0 +1,101 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../ob/event.hpp"
+#include "../chrono.hpp"
+
+namespace ntw::io {
+
+    template<class Handle, class Traits>
+    struct basic_async_file;
+
+    /// \brief The state of a single asynchronous read or write. Owns the I/O status
+    ///        block the system writes the result into and either an event that is
+    ///        signaled or a callback that is queued as an APC once the request completes.
+    ///
+    /// io::operation op(std::move(*ob::event::create(NotificationEvent)));
+    /// if(const auto s = file.read_async(buffer, offset, op); s == STATUS_PENDING)
+    ///     do_other_work();
+    /// op.wait();
+    /// \note Must stay at the same address and must not be reused until the request
+    ///       completes.
+    class operation {
+    public:
+        /// \brief Called with the completed operation from an APC on the thread that
+        ///        issued the request, once it enters an alertable wait.
+        using callback_type = void (*)(operation& op) noexcept;
+
+    private:
+        IO_STATUS_BLOCK _status_block = {};
+        ob::event       _event;
+        callback_type   _callback = nullptr;
+        void*           _context  = nullptr;
+
+        NTW_INLINE static void NTAPI _complete(void*            context,
+                                               IO_STATUS_BLOCK* status_block,
+                                               ULONG            reserved) noexcept;
+
+        NTW_INLINE void _begin() noexcept;
+
+        NTW_INLINE ntw::status _issued(ntw::status s) noexcept;
+
+        template<class Handle, class Traits>
+        friend struct basic_async_file;
+
+    public:
+        /// \brief Constructs operation whose completion can only be polled.
+        NTW_INLINE operation() noexcept = default;
+
+        /// \brief Constructs operation that signals the event once complete.
+        /// \param event A notification event is recommended, so every wait and not only
+        ///        the first one sees the completion.
+        NTW_INLINE explicit operation(ob::event event) noexcept;
+
+        /// \brief Constructs operation that calls the callback once complete.
+        /// \param context Value returned by context for use in the callback.
+        NTW_INLINE explicit operation(callback_type callback,
+                                      void*         context = nullptr) noexcept;
+
+        operation(const operation&) = delete;
+        operation& operator=(const operation&) = delete;
+
+        /// \brief Checks whether the request is still in progress.
+        NTW_INLINE bool pending() const noexcept;
+
+        /// \brief Returns the final status of the request or STATUS_PENDING.
+        NTW_INLINE ntw::status status() const noexcept;
+
+        /// \brief Returns the amount of bytes transferred by the completed request.
+        NTW_INLINE std::size_t transferred() const noexcept;
+
+        /// \brief Returns the context given to the constructor.
+        NTW_INLINE void* context() const noexcept;
+
+        /// \brief Returns the event signaled on completion.
+        NTW_INLINE const ob::event& event() const noexcept;
+
+        /// \brief Waits for the event and returns the final status of the request.
+        NTW_INLINE ntw::status wait() const noexcept;
+
+        /// \brief Waits for the event and returns the final status of the request.
+        /// \returns STATUS_TIMEOUT if the request did not complete in time.
+        NTW_INLINE ntw::status wait_for(duration timeout) const noexcept;
+    };
+
+} // namespace ntw::io
+
+#include "impl/operation.inl"
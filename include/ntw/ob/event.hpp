@@ -0,0 +1,94 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "attributes.hpp"
+#include "object.hpp"
+#include "../access.hpp"
+
+namespace ntw::ob {
+
+    /// \brief Extends access_builder to contain all event specific access flags.
+    struct event_access : access_builder<event_access> {
+        /// \brief Enables EVENT_QUERY_STATE flag
+        NTW_INLINE constexpr event_access& query_state();
+
+        /// \brief Enables EVENT_MODIFY_STATE flag
+        NTW_INLINE constexpr event_access& modify_state();
+
+        /// \brief Enables EVENT_ALL_ACCESS flag
+        NTW_INLINE constexpr event_access& all();
+    };
+
+    /// \brief Wrapper class around event object.
+    /// \note Waiting is done through the wait functions of basic_object.
+    template<class Handle>
+    struct basic_event : Handle {
+        /// \brief The type of handle that is used internally
+        using handle_type = Handle;
+        using access_type = event_access;
+
+        /// \brief Inherits constructors from handle type.
+        using handle_type::handle_type;
+        using handle_type::operator=;
+
+        NTW_INLINE basic_event() = default;
+
+        /// \brief Opens event using given name, access and attributes.
+        /// \param name The name of event object.
+        /// \param access The access to request for when opening event.
+        /// \param attr Optional extra attributes.
+        NTW_INLINE static result<basic_event> open(unicode_string    name,
+                                                   event_access      access,
+                                                   const attributes& attr = {}) noexcept;
+
+        /// \brief Creates an unnamed event.
+        /// \param type SynchronizationEvent resets itself after releasing a single
+        ///        waiter while NotificationEvent stays signaled until reset.
+        /// \param signaled The initial state of the event.
+        /// \param access The access to request for when creating event.
+        NTW_INLINE static result<basic_event>
+        create(EVENT_TYPE   type     = SynchronizationEvent,
+               bool         signaled = false,
+               event_access access   = event_access{}.all()) noexcept;
+
+        /// \brief Creates event using given name, access and attributes.
+        /// \param name The name of event object.
+        /// \param type The type of event.
+        /// \param signaled The initial state of the event.
+        /// \param access The access to request for when creating event.
+        /// \param attr Optional extra attributes.
+        NTW_INLINE static result<basic_event>
+        create(unicode_string    name,
+               EVENT_TYPE        type     = SynchronizationEvent,
+               bool              signaled = false,
+               event_access      access   = event_access{}.all(),
+               const attributes& attr     = {}) noexcept;
+
+        /// \brief Sets the event to signaled state.
+        NTW_INLINE status set() const noexcept;
+
+        /// \brief Sets the event to non signaled state.
+        /// \note Named clear as reset already replaces the stored handle.
+        NTW_INLINE status clear() const noexcept;
+    };
+
+    using event     = basic_event<object>;
+    using event_ref = basic_event<object_ref>;
+
+} // namespace ntw::ob
+
+#include "impl/event.inl"
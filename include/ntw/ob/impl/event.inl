@@ -0,0 +1,99 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../event.hpp"
+
+namespace ntw::ob {
+
+    NTW_INLINE constexpr event_access& event_access::query_state()
+    {
+        _access |= EVENT_QUERY_STATE;
+        return *this;
+    }
+
+    NTW_INLINE constexpr event_access& event_access::modify_state()
+    {
+        _access |= EVENT_MODIFY_STATE;
+        return *this;
+    }
+
+    NTW_INLINE constexpr event_access& event_access::all()
+    {
+        _access |= EVENT_ALL_ACCESS;
+        return *this;
+    }
+
+    template<class H>
+    NTW_INLINE result<basic_event<H>>
+               basic_event<H>::open(unicode_string    name,
+                                    event_access      access,
+                                    const attributes& attr) noexcept
+    {
+        OBJECT_ATTRIBUTES attributes = attr.get();
+        attributes.ObjectName        = &name.get();
+        void* handle;
+        return { NTW_SYSCALL(NtOpenEvent)(&handle, access.get(), &attributes),
+                 basic_event{ handle } };
+    }
+
+    template<class H>
+    NTW_INLINE result<basic_event<H>>
+               basic_event<H>::create(EVENT_TYPE   type,
+                                      bool         signaled,
+                                      event_access access) noexcept
+    {
+        void* handle;
+        return { NTW_SYSCALL(NtCreateEvent)(&handle,
+                                            access.get(),
+                                            nullptr,
+                                            type,
+                                            static_cast<BOOLEAN>(signaled)),
+                 basic_event{ handle } };
+    }
+
+    template<class H>
+    NTW_INLINE result<basic_event<H>>
+               basic_event<H>::create(unicode_string    name,
+                                      EVENT_TYPE        type,
+                                      bool              signaled,
+                                      event_access      access,
+                                      const attributes& attr) noexcept
+    {
+        OBJECT_ATTRIBUTES attributes = attr.get();
+        attributes.ObjectName        = &name.get();
+        void* handle;
+        return { NTW_SYSCALL(NtCreateEvent)(&handle,
+                                            access.get(),
+                                            &attributes,
+                                            type,
+                                            static_cast<BOOLEAN>(signaled)),
+                 basic_event{ handle } };
+    }
+
+    template<class H>
+    NTW_INLINE status basic_event<H>::set() const noexcept
+    {
+        return NTW_SYSCALL(NtSetEvent)(this->get(), nullptr);
+    }
+
+    template<class H>
+    NTW_INLINE status basic_event<H>::clear() const noexcept
+    {
+        return NTW_SYSCALL(NtResetEvent)(this->get(), nullptr);
+    }
+
+} // namespace ntw::ob
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../section.hpp"
+#include <utility>
+
+namespace ntw::detail {
+
+    NTW_INLINE ntw::status create_section(void**             handle,
+                                          unsigned long      access,
+                                          OBJECT_ATTRIBUTES* attributes,
+                                          std::uint64_t      size,
+                                          unsigned long      prot,
+                                          unsigned long      allocation,
+                                          void*              file) noexcept
+    {
+        LARGE_INTEGER max_size;
+        max_size.QuadPart = static_cast<LONGLONG>(size);
+        return NTW_SYSCALL(NtCreateSection)(handle,
+                                            access,
+                                            attributes,
+                                            size ? &max_size : nullptr,
+                                            prot,
+                                            allocation,
+                                            file);
+    }
+
+} // namespace ntw::detail
+
+namespace ntw::ob {
+
+    NTW_INLINE constexpr section_access& section_access::query()
+    {
+        _access |= SECTION_QUERY;
+        return *this;
+    }
+
+    NTW_INLINE constexpr section_access& section_access::map_read()
+    {
+        _access |= SECTION_MAP_READ;
+        return *this;
+    }
+
+    NTW_INLINE constexpr section_access& section_access::map_write()
+    {
+        _access |= SECTION_MAP_WRITE;
+        return *this;
+    }
+
+    NTW_INLINE constexpr section_access& section_access::map_execute()
+    {
+        _access |= SECTION_MAP_EXECUTE;
+        return *this;
+    }
+
+    NTW_INLINE constexpr section_access& section_access::extend_size()
+    {
+        _access |= SECTION_EXTEND_SIZE;
+        return *this;
+    }
+
+    NTW_INLINE constexpr section_access& section_access::all()
+    {
+        _access |= SECTION_ALL_ACCESS;
+        return *this;
+    }
+
+    NTW_INLINE section_view::section_view(void*       data,
+                                          std::size_t size,
+                                          void*       process) noexcept
+        : _process(process), _data(static_cast<std::uint8_t*>(data)), _size(size)
+    {}
+
+    NTW_INLINE section_view::~section_view() noexcept { static_cast<void>(unmap()); }
+
+    NTW_INLINE section_view::section_view(section_view&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    NTW_INLINE section_view& section_view::operator=(section_view&& other) noexcept
+    {
+        std::swap(_process, other._process);
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        return *this;
+    }
+
+    NTW_INLINE status section_view::unmap() noexcept
+    {
+        if(!_data)
+            return STATUS_SUCCESS;
+
+        const auto s = vm::unmap(_data, _process);
+        _data        = nullptr;
+        _size        = 0;
+        return s;
+    }
+
+    NTW_INLINE void* section_view::release() noexcept
+    {
+        _size = 0;
+        return std::exchange(_data, nullptr);
+    }
+
+    NTW_INLINE std::uint8_t* section_view::data() const noexcept { return _data; }
+
+    NTW_INLINE std::size_t section_view::size() const noexcept { return _size; }
+
+    NTW_INLINE std::span<std::uint8_t> section_view::span() const noexcept
+    {
+        return { _data, _size };
+    }
+
+    NTW_INLINE section_view::operator bool() const noexcept { return _data != nullptr; }
+
+    template<class H>
+    NTW_INLINE result<basic_section<H>>
+               basic_section<H>::open(unicode_string    name,
+                                      section_access    access,
+                                      const attributes& attr) noexcept
+    {
+        OBJECT_ATTRIBUTES attributes = attr.get();
+        attributes.ObjectName        = &name.get();
+        void* handle;
+        return { NTW_SYSCALL(NtOpenSection)(&handle, access.get(), &attributes),
+                 basic_section{ handle } };
+    }
+
+    template<class H>
+    NTW_INLINE result<basic_section<H>> basic_section<H>::create(
+        std::uint64_t size, vm::protection prot, section_access access) noexcept
+    {
+        void* handle;
+        return { ::ntw::detail::create_section(&handle,
+                                               access.get(),
+                                               nullptr,
+                                               size,
+                                               prot.get(),
+                                               SEC_COMMIT,
+                                               nullptr),
+                 basic_section{ handle } };
+    }
+
+    template<class H>
+    NTW_INLINE result<basic_section<H>>
+               basic_section<H>::create(unicode_string    name,
+                                        std::uint64_t     size,
+                                        vm::protection    prot,
+                                        section_access    access,
+                                        const attributes& attr) noexcept
+    {
+        OBJECT_ATTRIBUTES attributes = attr.get();
+        attributes.ObjectName        = &name.get();
+        void* handle;
+        return { ::ntw::detail::create_section(&handle,
+                                               access.get(),
+                                               &attributes,
+                                               size,
+                                               prot.get(),
+                                               SEC_COMMIT,
+                                               nullptr),
+                 basic_section{ handle } };
+    }
+
+    template<class H>
+    template<class File>
+    NTW_INLINE result<basic_section<H>>
+               basic_section<H>::create_from_file(const File&    file,
+                                                  vm::protection prot,
+                                                  std::uint64_t  size,
+                                                  section_access access) noexcept
+    {
+        void* handle;
+        return { ::ntw::detail::create_section(&handle,
+                                               access.get(),
+                                               nullptr,
+                                               size,
+                                               prot.get(),
+                                               SEC_COMMIT,
+                                               ::ntw::detail::unwrap(file)),
+                 basic_section{ handle } };
+    }
+
+    template<class H>
+    template<class File>
+    NTW_INLINE result<basic_section<H>>
+               basic_section<H>::create_image(const File&    file,
+                                              section_access access) noexcept
+    {
+        void* handle;
+        return { ::ntw::detail::create_section(&handle,
+                                               access.get(),
+                                               nullptr,
+                                               0,
+                                               PAGE_READONLY,
+                                               SEC_IMAGE,
+                                               ::ntw::detail::unwrap(file)),
+                 basic_section{ handle } };
+    }
+
+    template<class H>
+    template<class Process>
+    NTW_INLINE result<section_view>
+               basic_section<H>::map(std::size_t    size,
+                                     std::uint64_t  offset,
+                                     vm::protection prot,
+                                     const Process& process) const noexcept
+    {
+        const auto    target = ::ntw::detail::unwrap(process);
+        void*         base   = nullptr;
+        SIZE_T        view   = size;
+        LARGE_INTEGER section_offset;
+        section_offset.QuadPart = static_cast<LONGLONG>(offset);
+
+        const status s = NTW_SYSCALL(NtMapViewOfSection)(this->get(),
+                                                         target,
+                                                         &base,
+                                                         0,
+                                                         0,
+                                                         &section_offset,
+                                                         &view,
+                                                         ViewUnmap,
+                                                         0,
+                                                         prot.get());
+        if(!s.success())
+            return { s };
+        return { s, section_view{ base, view, target } };
+    }
+
+} // namespace ntw::ob
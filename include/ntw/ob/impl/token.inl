@@ -17,6 +17,18 @@
 #pragma once
 #include "../token.hpp"
 
+namespace ntw::detail {
+
+    struct privilege_state {
+        std::atomic<bool>         known  = false;
+        std::atomic<std::int32_t> status = 0;
+    };
+
+    // indexed by the privilege value which is far below the size for known privileges
+    inline privilege_state privilege_states[64];
+
+} // namespace ntw::detail
+
 namespace ntw::ob {
 
     NTW_INLINE constexpr privilege_with_attributes privilege::enable() const noexcept
@@ -389,4 +401,37 @@ namespace ntw::ob {
         return status;
     }
 
-} // namespace ntw::ob
\ No newline at end of file
+    NTW_INLINE status enable_privilege_once(privilege priv) noexcept
+    {
+        const auto enable = [priv]() -> status {
+            const auto tok =
+                token::open(process_ref{}, token_access{}.adjust_privileges());
+            if(!tok)
+                return tok.status();
+
+            // privileges missing from the token are reported with a success code
+            const auto s = tok->replace_privilege(priv.enable());
+            if(s == STATUS_NOT_ALL_ASSIGNED)
+                return STATUS_PRIVILEGE_NOT_HELD;
+            return s;
+        };
+
+        constexpr auto count = std::size(::ntw::detail::privilege_states);
+        if(priv.HighPart || priv.LowPart >= count)
+            return enable();
+
+        // racing threads may both enable it which is harmless
+        auto& state = ::ntw::detail::privilege_states[priv.LowPart];
+        if(state.known.load(std::memory_order_acquire))
+            return state.status.load(std::memory_order_relaxed);
+
+        // other failures such as running out of resources may not happen next time
+        const auto s = enable();
+        if(s.success() || s == STATUS_PRIVILEGE_NOT_HELD) {
+            state.status.store(s.get(), std::memory_order_relaxed);
+            state.known.store(true, std::memory_order_release);
+        }
+        return s;
+    }
+
+} // namespace ntw::ob
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "attributes.hpp"
+#include "object.hpp"
+#include "../access.hpp"
+#include "../vm/operation.hpp"
+#include "../vm/protection.hpp"
+#include <span>
+
+namespace ntw::ob {
+
+    /// \brief Extends access_builder to contain all section specific access flags.
+    struct section_access : access_builder<section_access> {
+        /// \brief Enables SECTION_QUERY flag
+        NTW_INLINE constexpr section_access& query();
+
+        /// \brief Enables SECTION_MAP_READ flag
+        NTW_INLINE constexpr section_access& map_read();
+
+        /// \brief Enables SECTION_MAP_WRITE flag
+        NTW_INLINE constexpr section_access& map_write();
+
+        /// \brief Enables SECTION_MAP_EXECUTE flag
+        NTW_INLINE constexpr section_access& map_execute();
+
+        /// \brief Enables SECTION_EXTEND_SIZE flag
+        NTW_INLINE constexpr section_access& extend_size();
+
+        /// \brief Enables SECTION_ALL_ACCESS flag
+        NTW_INLINE constexpr section_access& all();
+    };
+
+    /// \brief A mapped view of a section that is unmapped when it goes out of scope.
+    class section_view {
+        void*         _process = nullptr;
+        std::uint8_t* _data    = nullptr;
+        std::size_t   _size    = 0;
+
+    public:
+        NTW_INLINE section_view() noexcept = default;
+
+        /// \brief Takes ownership of a view mapped at data into the given process.
+        NTW_INLINE section_view(void* data, std::size_t size, void* process) noexcept;
+
+        NTW_INLINE ~section_view() noexcept;
+
+        section_view(const section_view&) = delete;
+        section_view& operator=(const section_view&) = delete;
+
+        NTW_INLINE section_view(section_view&& other) noexcept;
+
+        NTW_INLINE section_view& operator=(section_view&& other) noexcept;
+
+        /// \brief Unmaps the view now instead of at scope exit.
+        NTW_INLINE status unmap() noexcept;
+
+        /// \brief Gives up the ownership of the view without unmapping it.
+        /// \returns The base address of the view.
+        NTW_INLINE void* release() noexcept;
+
+        /// \brief Returns the base address of the view.
+        NTW_INLINE std::uint8_t* data() const noexcept;
+
+        /// \brief Returns the size of the view rounded up to the page size.
+        NTW_INLINE std::size_t size() const noexcept;
+
+        /// \brief Returns the whole view as a span.
+        NTW_INLINE std::span<std::uint8_t> span() const noexcept;
+
+        /// \brief Checks whether a view is mapped.
+        NTW_INLINE explicit operator bool() const noexcept;
+    };
+
+    /// \brief Wrapper class around section object.
+    template<class Handle>
+    struct basic_section : Handle {
+        /// \brief The type of handle that is used internally
+        using handle_type = Handle;
+        using access_type = section_access;
+
+        /// \brief Inherits constructors from handle type.
+        using handle_type::handle_type;
+        using handle_type::operator=;
+
+        NTW_INLINE basic_section() = default;
+
+        /// \brief Opens section using given name, access and attributes.
+        /// \param name The name of section object.
+        /// \param access The access to request for when opening section.
+        /// \param attr Optional extra attributes.
+        NTW_INLINE static result<basic_section>
+        open(unicode_string    name,
+             section_access    access,
+             const attributes& attr = {}) noexcept;
+
+        /// \brief Creates an unnamed section backed by the paging file.
+        /// \param size The maximum size of the section.
+        /// \param prot The protection of pages of the section.
+        /// \param access The access to request for when creating section.
+        NTW_INLINE static result<basic_section>
+        create(std::uint64_t  size,
+               vm::protection prot   = vm::protection::read_write(),
+               section_access access = section_access{}.all()) noexcept;
+
+        /// \brief Creates section backed by the paging file using given name, access
+        ///        and attributes.
+        /// \param name The name of section object.
+        /// \param size The maximum size of the section.
+        /// \param prot The protection of pages of the section.
+        /// \param access The access to request for when creating section.
+        /// \param attr Optional extra attributes.
+        NTW_INLINE static result<basic_section>
+        create(unicode_string    name,
+               std::uint64_t     size,
+               vm::protection    prot   = vm::protection::read_write(),
+               section_access    access = section_access{}.all(),
+               const attributes& attr   = {}) noexcept;
+
+        /// \brief Creates an unnamed section backed by a file.
+        /// \param file The file handle. Needs read data access and write data access if
+        ///        the protection is writeable.
+        /// \param prot The protection of pages of the section.
+        /// \param size The maximum size of the section. 0 uses the size of the file.
+        /// \param access The access to request for when creating section.
+        template<class File>
+        NTW_INLINE static result<basic_section> create_from_file(
+            const File&    file,
+            vm::protection prot   = vm::protection::read(),
+            std::uint64_t  size   = 0,
+            section_access access = section_access{}.query().map_read()) noexcept;
+
+        /// \brief Creates an unnamed section that maps an executable file as an image.
+        /// \param file The file handle. Needs read data and execute access.
+        /// \param access The access to request for when creating section.
+        template<class File>
+        NTW_INLINE static result<basic_section> create_image(
+            const File&    file,
+            section_access access = section_access{}.query().map_read()) noexcept;
+
+        /// \brief Maps a view of the section.
+        /// \param size The size of the view. 0 maps everything from offset to the end.
+        /// \param offset The offset of the view in the section. Must be a multiple of
+        ///        the allocation granularity.
+        /// \param prot The protection of the view.
+        /// \param process The process to map the view into.
+        template<class Process = void*>
+        NTW_INLINE result<section_view>
+        map(std::size_t    size    = 0,
+            std::uint64_t  offset  = 0,
+            vm::protection prot    = vm::protection::read_write(),
+            const Process& process = NtCurrentProcess()) const noexcept;
+    };
+
+    using section     = basic_section<object>;
+    using section_ref = basic_section<object_ref>;
+
+} // namespace ntw::ob
+
+#include "impl/section.inl"
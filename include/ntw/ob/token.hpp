@@ -18,6 +18,8 @@
 #include "object.hpp"
 #include "process.hpp"
 #include "thread.hpp"
+#include <atomic>
+#include <iterator>
 
 namespace ntw::ob {
 
@@ -223,6 +225,15 @@ namespace ntw::ob {
     using token     = basic_token<object>;
     using token_ref = basic_token<object_ref>;
 
+    /// \brief Enables the privilege in the token of current process the first time it
+    ///        is called for it and returns the remembered outcome on later calls.
+    ///        Only success and STATUS_PRIVILEGE_NOT_HELD are remembered, other errors
+    ///        are retried on the next call.
+    /// \returns STATUS_PRIVILEGE_NOT_HELD if the token does not have the privilege.
+    /// \note Meant for code paths that need a privilege on demand, such as large page
+    ///       allocations, without adjusting the token on every call.
+    NTW_INLINE status enable_privilege_once(privilege priv) noexcept;
+
 } // namespace ntw::ob
 
 #include "impl/token.inl"
\ No newline at end of file
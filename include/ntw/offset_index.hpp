@@ -0,0 +1,181 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "detail/growable_buffer.hpp"
+#include <algorithm>
+#include <compare>
+
+namespace ntw {
+
+    namespace detail {
+
+        /// \brief Random access iterator that dereferences an array of pointers.
+        template<class T>
+        class indirect_iterator {
+            T* const* _ptr = nullptr;
+
+        public:
+            using difference_type   = std::ptrdiff_t;
+            using value_type        = std::remove_cv_t<T>;
+            using pointer           = T*;
+            using reference         = T&;
+            using iterator_category = std::random_access_iterator_tag;
+
+            NTW_INLINE constexpr indirect_iterator() noexcept = default;
+
+            NTW_INLINE constexpr explicit indirect_iterator(T* const* ptr) noexcept
+                : _ptr(ptr)
+            {}
+
+            NTW_INLINE constexpr reference operator*() const noexcept { return **_ptr; }
+
+            NTW_INLINE constexpr pointer operator->() const noexcept { return *_ptr; }
+
+            NTW_INLINE constexpr reference operator[](difference_type n) const noexcept
+            {
+                return *_ptr[n];
+            }
+
+            NTW_INLINE constexpr indirect_iterator& operator++() noexcept
+            {
+                ++_ptr;
+                return *this;
+            }
+
+            NTW_INLINE constexpr indirect_iterator operator++(int) noexcept
+            {
+                auto tmp = *this;
+                ++_ptr;
+                return tmp;
+            }
+
+            NTW_INLINE constexpr indirect_iterator& operator--() noexcept
+            {
+                --_ptr;
+                return *this;
+            }
+
+            NTW_INLINE constexpr indirect_iterator operator--(int) noexcept
+            {
+                auto tmp = *this;
+                --_ptr;
+                return tmp;
+            }
+
+            NTW_INLINE constexpr indirect_iterator& operator+=(difference_type n) noexcept
+            {
+                _ptr += n;
+                return *this;
+            }
+
+            NTW_INLINE constexpr indirect_iterator& operator-=(difference_type n) noexcept
+            {
+                _ptr -= n;
+                return *this;
+            }
+
+            NTW_INLINE constexpr friend indirect_iterator
+            operator+(indirect_iterator it, difference_type n) noexcept
+            {
+                return it += n;
+            }
+
+            NTW_INLINE constexpr friend indirect_iterator
+            operator+(difference_type n, indirect_iterator it) noexcept
+            {
+                return it += n;
+            }
+
+            NTW_INLINE constexpr friend indirect_iterator
+            operator-(indirect_iterator it, difference_type n) noexcept
+            {
+                return it -= n;
+            }
+
+            NTW_INLINE constexpr friend difference_type
+            operator-(indirect_iterator lhs, indirect_iterator rhs) noexcept
+            {
+                return lhs._ptr - rhs._ptr;
+            }
+
+            NTW_INLINE constexpr friend bool operator==(indirect_iterator lhs,
+                                                        indirect_iterator rhs) noexcept
+            {
+                return lhs._ptr == rhs._ptr;
+            }
+
+            NTW_INLINE constexpr friend std::strong_ordering
+            operator<=>(indirect_iterator lhs, indirect_iterator rhs) noexcept
+            {
+                return lhs._ptr <=> rhs._ptr;
+            }
+        };
+
+    } // namespace detail
+
+    /// \brief Records pointers to the entries of a linked offset list (processes,
+    ///        modules ...) in a single pass to allow random access, O(1) size and
+    ///        sorting / binary searching by a key.
+    /// \note The storage is kept between assignments.
+    /// \note Iterators dereference to the entries themselves and are read only, so
+    ///       algorithms can't reorder the entries in place. Entries are not movable,
+    ///       reordering has to be done through pointers() or sort_by().
+    template<class T>
+    class offset_index {
+        detail::growable_buffer _buffer;
+        std::size_t             _size = 0;
+
+    public:
+        using value_type     = T;
+        using pointer        = T*;
+        using reference      = const T&;
+        using iterator       = detail::indirect_iterator<const T>;
+        using const_iterator = iterator;
+
+        NTW_INLINE offset_index() noexcept = default;
+
+        /// \brief Records the entries of range, replacing the previous contents.
+        template<class Range>
+        NTW_INLINE status assign(Range&& range) noexcept;
+
+        NTW_INLINE std::size_t size() const noexcept;
+
+        NTW_INLINE bool empty() const noexcept;
+
+        NTW_INLINE reference operator[](std::size_t idx) const noexcept;
+
+        NTW_INLINE iterator begin() const noexcept;
+
+        NTW_INLINE iterator end() const noexcept;
+
+        /// \brief Returns the recorded entry pointers in their current order.
+        NTW_INLINE std::span<pointer> pointers() const noexcept;
+
+        /// \brief Sorts the entries by the value returned from key(entry).
+        template<class Key>
+        NTW_INLINE void sort_by(Key key) noexcept;
+
+        /// \brief Binary searches for an entry where key(entry) == value.
+        /// \note The index must be sorted using sort_by with the same key.
+        /// \returns Pointer to the entry or nullptr.
+        template<class Value, class Key>
+        NTW_INLINE pointer find(const Value& value, Key key) const noexcept;
+    };
+
+} // namespace ntw
+
+#include "impl/offset_index.inl"
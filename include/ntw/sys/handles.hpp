@@ -0,0 +1,114 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "../result.hpp"
+
+namespace ntw::sys {
+
+    /// \brief A wrapper around SYSTEM_HANDLE_TABLE_ENTRY_INFO_EX class
+    struct handle_entry {
+        void*          object;
+        std::uintptr_t process_id; // UniqueProcessId
+        std::uintptr_t value; // HandleValue
+        std::uint32_t  granted_access;
+        std::uint16_t  creator_back_trace_index;
+        std::uint16_t  object_type_index;
+        std::uint32_t  attributes; // HandleAttributes
+        std::uint32_t  reserved;
+    };
+
+    /// \brief Queries the handles of all processes using NtQuerySystemInformation with
+    ///        SystemExtendedHandleInformation class.
+    /// \param buffer Buffer into which handle information will be read into.
+    /// \param returned The amount of bytes used inside the buffer.
+    /// \returns A span over the entries inside of buffer.
+    template<class Range>
+    NTW_INLINE ntw::result<std::span<handle_entry>>
+    handles(Range&& buffer, ulong_t* returned = nullptr) noexcept;
+
+    /// \brief Owns the buffer that handles() is queried into. The buffer is grown
+    ///        geometrically on STATUS_INFO_LENGTH_MISMATCH and kept between refreshes.
+    class handle_snapshot {
+        ntw::detail::growable_buffer _buffer;
+        std::span<handle_entry>      _entries;
+
+    public:
+        /// \brief The size of the first allocation if reserve was not called.
+        constexpr static std::size_t initial_size = 0x100000;
+
+        /// \brief Constructs an empty snapshot without allocating.
+        NTW_INLINE handle_snapshot() noexcept = default;
+
+        /// \brief Preallocates the internal buffer.
+        /// \param size The size of buffer in bytes.
+        NTW_INLINE status reserve(std::size_t size) noexcept;
+
+        /// \brief Queries the current list of handles into the owned buffer.
+        /// \note On failure the snapshot becomes empty.
+        NTW_INLINE status refresh() noexcept;
+
+        /// \brief Returns the entries from the last successful refresh.
+        NTW_INLINE std::span<handle_entry> entries() const noexcept;
+
+        /// \brief Returns the size of owned buffer in bytes.
+        NTW_INLINE std::size_t capacity() const noexcept;
+    };
+
+    /// \brief Groups handle entries by their process id and by their object type
+    ///        index using a counting sort.
+    /// \note Both groupings are produced together: one counting pass and one scatter
+    ///       pass over the entries. The storage is kept between assignments.
+    /// \note Process ids are bucketed as id / 4, as process ids are multiples of 4.
+    class handle_groups {
+        ntw::detail::growable_buffer _by_process;
+        ntw::detail::growable_buffer _by_type;
+        ntw::detail::growable_buffer _process_ends;
+        ntw::detail::growable_buffer _type_ends;
+        std::size_t                  _process_buckets = 0;
+        std::size_t                  _type_buckets    = 0;
+
+        NTW_INLINE static status _count(ntw::detail::growable_buffer& counts,
+                                         std::size_t&                  buckets,
+                                         std::size_t                   bucket) noexcept;
+
+        NTW_INLINE static std::span<const std::uint32_t>
+        _bucket(const ntw::detail::growable_buffer& order,
+                const ntw::detail::growable_buffer& ends,
+                std::size_t                         buckets,
+                std::size_t                         bucket) noexcept;
+
+    public:
+        NTW_INLINE handle_groups() noexcept = default;
+
+        /// \brief Groups the entries, replacing the previous contents.
+        NTW_INLINE status assign(std::span<const handle_entry> entries) noexcept;
+
+        /// \brief Returns the indices of entries owned by the process in increasing
+        ///        order. Ids that are not a multiple of 4 have no entries.
+        NTW_INLINE std::span<const std::uint32_t>
+        by_process(std::uintptr_t process_id) const noexcept;
+
+        /// \brief Returns the indices of entries with the object type index in
+        ///        increasing order.
+        NTW_INLINE std::span<const std::uint32_t>
+        by_type(std::uint16_t object_type_index) const noexcept;
+    };
+
+} // namespace ntw::sys
+
+#include "impl/handles.inl"
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../handles.hpp"
+
+namespace ntw::sys {
+
+    static_assert(sizeof(handle_entry) == sizeof(SYSTEM_HANDLE_TABLE_ENTRY_INFO_EX));
+    static_assert(offsetof(handle_entry, object_type_index) ==
+                  offsetof(SYSTEM_HANDLE_TABLE_ENTRY_INFO_EX, ObjectTypeIndex));
+
+    template<class Range>
+    NTW_INLINE ::ntw::result<std::span<handle_entry>>
+    handles(Range&& buffer, ulong_t* returned) noexcept
+    {
+        const auto  first  = ::ntw::detail::unfancy(::ntw::detail::adl_begin(buffer));
+        const auto  size   = static_cast<ulong_t>(::ntw::detail::range_byte_size(buffer));
+        ntw::status status = NTW_SYSCALL(NtQuerySystemInformation)(
+            SystemExtendedHandleInformation, first, size, returned);
+
+        // the count is only valid if the query succeeded
+        const auto info = reinterpret_cast<SYSTEM_HANDLE_INFORMATION_EX*>(first);
+        return { status,
+                 std::span<handle_entry>{
+                     reinterpret_cast<handle_entry*>(info->Handles),
+                     status.success() ? info->NumberOfHandles : 0 } };
+    }
+
+    NTW_INLINE status handle_snapshot::reserve(std::size_t size) noexcept
+    {
+        return _buffer.reserve(size);
+    }
+
+    NTW_INLINE status handle_snapshot::refresh() noexcept
+    {
+        _entries = {};
+
+        std::span<handle_entry> entries;
+        const auto              s = ntw::detail::query_growing(
+            _buffer, initial_size, [&entries](auto& buffer, ulong_t* returned) {
+                const auto res = handles(buffer.span(), returned);
+                entries        = *res;
+                return res.status();
+            });
+
+        if(s.success())
+            _entries = entries;
+        return s;
+    }
+
+    NTW_INLINE std::span<handle_entry> handle_snapshot::entries() const noexcept
+    {
+        return _entries;
+    }
+
+    NTW_INLINE std::size_t handle_snapshot::capacity() const noexcept
+    {
+        return _buffer.size();
+    }
+
+    NTW_INLINE status handle_groups::_count(ntw::detail::growable_buffer& counts,
+                                            std::size_t&                  buckets,
+                                            std::size_t                   bucket) noexcept
+    {
+        if(bucket >= buckets) {
+            const auto s = counts.reserve((bucket + 1) * sizeof(std::uint32_t), true);
+            if(!s.success())
+                return s;
+
+            std::memset(counts.as<std::uint32_t>() + buckets,
+                        0,
+                        (bucket + 1 - buckets) * sizeof(std::uint32_t));
+            buckets = bucket + 1;
+        }
+
+        ++counts.as<std::uint32_t>()[bucket];
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE std::span<const std::uint32_t>
+    handle_groups::_bucket(const ntw::detail::growable_buffer& order,
+                           const ntw::detail::growable_buffer& ends,
+                           std::size_t                         buckets,
+                           std::size_t                         bucket) noexcept
+    {
+        if(bucket >= buckets)
+            return {};
+
+        const auto last  = ends.as<const std::uint32_t>()[bucket];
+        const auto first = bucket ? ends.as<const std::uint32_t>()[bucket - 1] : 0;
+        return { order.as<const std::uint32_t>() + first, last - first };
+    }
+
+    NTW_INLINE status
+    handle_groups::assign(std::span<const handle_entry> entries) noexcept
+    {
+        _process_buckets = 0;
+        _type_buckets    = 0;
+
+        const auto order_size = entries.size() * sizeof(std::uint32_t);
+        if(auto s = _by_process.reserve(order_size); !s.success())
+            return s;
+        if(auto s = _by_type.reserve(order_size); !s.success())
+            return s;
+
+        for(const auto& e : entries) {
+            auto s = _count(_process_ends, _process_buckets, e.process_id / 4);
+            if(s.success())
+                s = _count(_type_ends, _type_buckets, e.object_type_index);
+
+            if(!s.success()) {
+                _process_buckets = 0;
+                _type_buckets    = 0;
+                return s;
+            }
+        }
+
+        // turn the counts into bucket starts
+        const auto exclusive_scan = [](std::uint32_t* counts, std::size_t buckets) {
+            std::uint32_t offset = 0;
+            for(std::size_t i = 0; i < buckets; ++i) {
+                const auto count = counts[i];
+                counts[i]        = offset;
+                offset += count;
+            }
+        };
+
+        const auto process_ends = _process_ends.as<std::uint32_t>();
+        const auto type_ends    = _type_ends.as<std::uint32_t>();
+        exclusive_scan(process_ends, _process_buckets);
+        exclusive_scan(type_ends, _type_buckets);
+
+        // after the scatter every start is advanced to the end of its bucket
+        const auto by_process = _by_process.as<std::uint32_t>();
+        const auto by_type    = _by_type.as<std::uint32_t>();
+        for(std::uint32_t i = 0; i < entries.size(); ++i) {
+            const auto& e = entries[i];
+            by_process[process_ends[e.process_id / 4]++] = i;
+            by_type[type_ends[e.object_type_index]++]    = i;
+        }
+
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE std::span<const std::uint32_t>
+    handle_groups::by_process(std::uintptr_t process_id) const noexcept
+    {
+        // would otherwise share the bucket of the process id below it
+        if(process_id % 4)
+            return {};
+
+        return _bucket(_by_process, _process_ends, _process_buckets, process_id / 4);
+    }
+
+    NTW_INLINE std::span<const std::uint32_t>
+    handle_groups::by_type(std::uint16_t object_type_index) const noexcept
+    {
+        return _bucket(_by_type, _type_ends, _type_buckets, object_type_index);
+    }
+
+} // namespace ntw::sys
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../module_index.hpp"
+
+namespace ntw::sys {
+
+    template<class Range>
+    NTW_INLINE status module_index::assign(Range&& range) noexcept
+    {
+        _size = 0;
+
+        auto        entries  = _buffer.as<module_interval>();
+        std::size_t capacity = _buffer.size() / sizeof(module_interval);
+        for(const auto& m : range) {
+            if(_size == capacity) {
+                const auto new_capacity = capacity ? capacity * 2 : 256;
+                const auto s =
+                    _buffer.reserve(new_capacity * sizeof(module_interval), true);
+                if(!s.success()) {
+                    _size = 0;
+                    return s;
+                }
+
+                entries  = _buffer.as<module_interval>();
+                capacity = _buffer.size() / sizeof(module_interval);
+            }
+
+            entries[_size++] = { reinterpret_cast<std::uintptr_t>(m.image_base),
+                                 m.image_size,
+                                 &m };
+        }
+
+        std::sort(entries,
+                  entries + _size,
+                  [](const module_interval& lhs, const module_interval& rhs) {
+                      return lhs.base < rhs.base;
+                  });
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE std::size_t module_index::size() const noexcept { return _size; }
+
+    NTW_INLINE bool module_index::empty() const noexcept { return !_size; }
+
+    NTW_INLINE std::span<const module_interval> module_index::intervals() const noexcept
+    {
+        return { _buffer.as<const module_interval>(), _size };
+    }
+
+    NTW_INLINE const loaded_module*
+    module_index::find(std::uintptr_t address) const noexcept
+    {
+        if(!_size)
+            return nullptr;
+
+        // finds the last interval starting at or before the address. The conditional
+        // move keeps the loop free of unpredictable branches.
+        auto        first = _buffer.as<const module_interval>();
+        std::size_t len   = _size;
+        while(len > 1) {
+            const auto half = len / 2;
+            first           = first[half].base <= address ? first + half : first;
+            len -= half;
+        }
+
+        return address - first->base < first->size ? first->module : nullptr;
+    }
+
+    NTW_INLINE const loaded_module*
+    module_index::find(const void* address) const noexcept
+    {
+        return find(reinterpret_cast<std::uintptr_t>(address));
+    }
+
+    NTW_INLINE void
+    module_index::find(std::span<const std::uintptr_t> addresses,
+                       std::span<const loaded_module*> modules) const noexcept
+    {
+        const auto entries = _buffer.as<const module_interval>();
+        const auto count   = addresses.size();
+
+        std::size_t i = 0;
+        for(; _size && i + batch_size <= count; i += batch_size) {
+            const module_interval* first[batch_size];
+            for(std::size_t j = 0; j < batch_size; ++j)
+                first[j] = entries;
+
+            // every search takes the same amount of steps so they can run in lockstep
+            for(std::size_t len = _size; len > 1;) {
+                const auto half = len / 2;
+                for(std::size_t j = 0; j < batch_size; ++j)
+                    first[j] = first[j][half].base <= addresses[i + j] ? first[j] + half
+                                                                       : first[j];
+                len -= half;
+            }
+
+            for(std::size_t j = 0; j < batch_size; ++j) {
+                const auto interval = first[j];
+                modules[i + j]      = addresses[i + j] - interval->base < interval->size
+                                          ? interval->module
+                                          : nullptr;
+            }
+        }
+
+        for(; i < count; ++i)
+            modules[i] = find(addresses[i]);
+    }
+
+} // namespace ntw::sys
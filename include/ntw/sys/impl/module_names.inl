@@ -0,0 +1,111 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../module_names.hpp"
+
+namespace ntw::sys {
+
+    NTW_INLINE constexpr char module_name_table::_fold(char c) noexcept
+    {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    NTW_INLINE constexpr std::uint32_t
+    module_name_table::_hash(std::string_view name) noexcept
+    {
+        // FNV-1a over the case folded name
+        std::uint32_t h = 0x811C9DC5;
+        for(const auto c : name)
+            h = (h ^ static_cast<std::uint8_t>(_fold(c))) * 0x01000193;
+        return h;
+    }
+
+    NTW_INLINE bool module_name_table::_equal(const char*      lhs,
+                                              std::string_view rhs) noexcept
+    {
+        for(std::size_t i = 0; i < rhs.size(); ++i)
+            if(_fold(lhs[i]) != _fold(rhs[i]))
+                return false;
+        return true;
+    }
+
+    template<class Range>
+    NTW_INLINE status module_name_table::assign(Range&& range) noexcept
+    {
+        _size = 0;
+
+        std::size_t count = 0;
+        for(auto it = std::begin(range); it != std::end(range); ++it)
+            ++count;
+
+        // keep the load factor at or below 1/2
+        std::size_t capacity = 16;
+        while(capacity < count * 2)
+            capacity *= 2;
+
+        if(const auto s = _buffer.reserve(capacity * sizeof(slot)); !s.success()) {
+            _mask = 0;
+            return s;
+        }
+
+        // the buffer may have grown past what we asked for
+        capacity = _buffer.size() / sizeof(slot);
+        while(capacity & (capacity - 1))
+            capacity &= capacity - 1;
+
+        _mask = capacity - 1;
+        std::memset(_buffer.data(), 0, capacity * sizeof(slot));
+
+        const auto table = _buffer.as<slot>();
+        for(const auto& m : range) {
+            const auto name = m.name_view();
+            const auto hash = _hash(name);
+
+            auto i = hash & _mask;
+            while(table[i].module)
+                i = (i + 1) & _mask;
+
+            table[i] = { hash, static_cast<std::uint32_t>(name.size()), &m };
+            ++_size;
+        }
+
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE std::size_t module_name_table::size() const noexcept { return _size; }
+
+    NTW_INLINE bool module_name_table::empty() const noexcept { return !_size; }
+
+    NTW_INLINE const loaded_module*
+    module_name_table::find(std::string_view name) const noexcept
+    {
+        if(!_size)
+            return nullptr;
+
+        const auto table = _buffer.as<const slot>();
+        const auto hash  = _hash(name);
+        for(auto i = hash & _mask; table[i].module; i = (i + 1) & _mask) {
+            const auto& s = table[i];
+            if(s.hash == hash && s.length == name.size() &&
+               _equal(s.module->name(), name))
+                return s.module;
+        }
+
+        return nullptr;
+    }
+
+} // namespace ntw::sys
@@ -26,17 +26,20 @@ namespace ntw::sys {
 
     NTW_INLINE std::string_view loaded_module::name_view() const noexcept
     {
-        const auto first = name();
-        auto       last  = first;
-        while(*last)
-            ++last;
+        // a malformed entry can point the name past the end of path
+        if(file_name_offset >= sizeof(path))
+            return {};
 
-        return std::string_view(first,
-                                static_cast<std::string_view::size_type>(last - first));
+        const auto first = name();
+        return std::string_view(
+            first, detail::simd::string_length(first, sizeof(path) - file_name_offset));
     }
 
     NTW_INLINE std::string_view loaded_module::path_view() const noexcept
     {
+        if(file_name_offset >= sizeof(path))
+            return { path, detail::simd::string_length(path, sizeof(path)) };
+
         auto driver_name = name_view();
         return { driver_name.data() - file_name_offset,
                  driver_name.size() + file_name_offset };
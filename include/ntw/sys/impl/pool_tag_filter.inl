@@ -0,0 +1,148 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../pool_tag_filter.hpp"
+
+namespace ntw::sys {
+
+    NTW_INLINE constexpr pool_tag_pattern::pool_tag_pattern(std::uint32_t value,
+                                                            std::uint32_t mask) noexcept
+        : value(value & mask), mask(mask)
+    {}
+
+    NTW_INLINE constexpr pool_tag_pattern::pool_tag_pattern(
+        std::string_view pattern) noexcept
+    {
+        // the first character of tag is stored in the lowest byte
+        for(std::size_t i = 0; i < 4; ++i) {
+            const auto shift = i * 8;
+            if(i >= pattern.size()) {
+                value |= std::uint32_t{ ' ' } << shift;
+                mask |= 0xFFu << shift;
+            }
+            else if(pattern[i] == '*')
+                break;
+            else if(pattern[i] != '?') {
+                value |= std::uint32_t{ static_cast<std::uint8_t>(pattern[i]) } << shift;
+                mask |= 0xFFu << shift;
+            }
+        }
+    }
+
+    NTW_INLINE constexpr pool_tag_pattern::pool_tag_pattern(const char* pattern) noexcept
+        : pool_tag_pattern(std::string_view(pattern))
+    {}
+
+    NTW_INLINE constexpr bool pool_tag_pattern::matches(std::uint32_t tag) const noexcept
+    {
+        return (tag & mask) == value;
+    }
+
+    NTW_INLINE const std::uint32_t* pool_tag_filter::_values() const noexcept
+    {
+        return _patterns.as<const std::uint32_t>();
+    }
+
+    NTW_INLINE const std::uint32_t* pool_tag_filter::_masks() const noexcept
+    {
+        return _patterns.as<const std::uint32_t>() + _capacity;
+    }
+
+    NTW_INLINE status pool_tag_filter::add(pool_tag_pattern pattern) noexcept
+    {
+        if(_size == _capacity) {
+            const auto capacity = _capacity ? _capacity * 2 : 64;
+
+            ntw::detail::growable_buffer patterns;
+            const auto s = patterns.reserve(capacity * 2 * sizeof(std::uint32_t));
+            if(!s.success())
+                return s;
+
+            // the buffer is empty before the first growth
+            if(_size) {
+                const auto values = patterns.as<std::uint32_t>();
+                std::memcpy(values, _values(), _size * sizeof(std::uint32_t));
+                std::memcpy(values + capacity, _masks(), _size * sizeof(std::uint32_t));
+            }
+
+            _patterns = std::move(patterns);
+            _capacity = capacity;
+        }
+
+        const auto values         = _patterns.as<std::uint32_t>();
+        values[_size]             = pattern.value;
+        values[_capacity + _size] = pattern.mask;
+        ++_size;
+        return STATUS_SUCCESS;
+    }
+
+    template<class Range>
+    NTW_INLINE status pool_tag_filter::add_range(const Range& patterns) noexcept
+    {
+        for(const auto& pattern : patterns)
+            if(const auto s = add(pool_tag_pattern(pattern)); !s.success())
+                return s;
+
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE void pool_tag_filter::clear() noexcept { _size = 0; }
+
+    NTW_INLINE std::size_t pool_tag_filter::size() const noexcept { return _size; }
+
+    NTW_INLINE bool pool_tag_filter::empty() const noexcept { return !_size; }
+
+    NTW_INLINE bool pool_tag_filter::matches(std::uint32_t tag) const noexcept
+    {
+        return ntw::detail::simd::any_masked_equal(tag, _values(), _masks(), _size);
+    }
+
+    NTW_INLINE std::size_t
+    pool_tag_filter::filter(std::span<const system_pooltag> tags,
+                            std::span<std::uint32_t>        out) const noexcept
+    {
+        const auto count  = tags.size();
+        const auto limit  = out.size();
+        const auto values = _values();
+        const auto masks  = _masks();
+
+        using ntw::detail::simd::any_masked_equal;
+        using ntw::detail::simd::any_masked_equal4;
+
+        std::size_t n = 0;
+        std::size_t i = 0;
+        if(_size <= tag_lanes_limit) {
+            // tags are not contiguous so they are packed into a vector first
+            for(; i + 4 <= count && n + 4 <= limit; i += 4) {
+                const std::uint32_t lanes[4] = {
+                    tags[i].tag, tags[i + 1].tag, tags[i + 2].tag, tags[i + 3].tag
+                };
+
+                auto bits = any_masked_equal4(lanes, values, masks, _size);
+                for(; bits; bits &= bits - 1)
+                    out[n++] = static_cast<std::uint32_t>(i + std::countr_zero(bits));
+            }
+        }
+
+        for(; i < count && n < limit; ++i)
+            if(any_masked_equal(tags[i].tag, values, masks, _size))
+                out[n++] = static_cast<std::uint32_t>(i);
+
+        return n;
+    }
+
+} // namespace ntw::sys
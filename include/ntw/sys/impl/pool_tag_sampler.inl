@@ -0,0 +1,216 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../pool_tag_sampler.hpp"
+
+namespace ntw::sys {
+
+    NTW_INLINE constexpr std::size_t pool_tag_sampler::_hash(std::uint32_t tag) noexcept
+    {
+        return static_cast<std::size_t>((tag * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+    NTW_INLINE pool_tag_sampler::counters*
+    pool_tag_sampler::_sample(std::size_t age) const noexcept
+    {
+        const auto idx = (_head + _history - 1 - age) % _history;
+        return _ring.as<counters>() + idx * _capacity;
+    }
+
+    NTW_INLINE void pool_tag_sampler::_insert(std::uint32_t tag,
+                                              std::uint32_t row) const noexcept
+    {
+        const auto table = _table.as<slot>();
+
+        auto i = _hash(tag) & _mask;
+        while(table[i].row)
+            i = (i + 1) & _mask;
+
+        table[i] = { tag, row + 1 };
+    }
+
+    NTW_INLINE status pool_tag_sampler::_grow(std::size_t capacity) noexcept
+    {
+        std::size_t new_capacity = _capacity ? _capacity : 64;
+        while(new_capacity < capacity)
+            new_capacity *= 2;
+
+        // the samples are laid out by capacity so they have to be copied row by row
+        ntw::detail::growable_buffer ring;
+        const auto ring_size = _history * new_capacity * sizeof(counters);
+        if(const auto s = ring.reserve(ring_size); !s.success())
+            return s;
+
+        std::memset(ring.data(), 0, ring_size);
+        for(std::size_t i = 0; _capacity && i < _history; ++i)
+            std::memcpy(ring.as<counters>() + i * new_capacity,
+                        _ring.as<counters>() + i * _capacity,
+                        _capacity * sizeof(counters));
+
+        if(const auto s = _tags.reserve(new_capacity * sizeof(std::uint32_t), true);
+           !s.success())
+            return s;
+
+        // keep the load factor at or below 1/2
+        const auto table_size = new_capacity * 2 * sizeof(slot);
+        if(const auto s = _table.reserve(table_size); !s.success())
+            return s;
+
+        _ring     = std::move(ring);
+        _capacity = new_capacity;
+        _mask     = new_capacity * 2 - 1;
+        std::memset(_table.data(), 0, table_size);
+
+        const auto tags = _tags.as<std::uint32_t>();
+        for(std::uint32_t row = 0; row < _rows; ++row)
+            _insert(tags[row], row);
+
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE std::uint32_t pool_tag_sampler::_row(std::uint32_t tag) noexcept
+    {
+        const auto table = _table.as<slot>();
+        for(auto i = _hash(tag) & _mask; table[i].row; i = (i + 1) & _mask)
+            if(table[i].tag == tag)
+                return table[i].row - 1;
+
+        const auto row                 = static_cast<std::uint32_t>(_rows++);
+        _tags.as<std::uint32_t>()[row] = tag;
+        _insert(tag, row);
+        return row;
+    }
+
+    template<class Key>
+    NTW_INLINE std::size_t pool_tag_sampler::_top(pool_type                  type,
+                                                  std::span<pool_tag_growth> out,
+                                                  std::size_t                window,
+                                                  Key key) const noexcept
+    {
+        window = std::min(window, _count);
+        if(window < 2 || out.empty())
+            return 0;
+
+        // orders tags from the largest growth, so the heap top is the smallest one
+        const auto better = [key](const pool_tag_growth& lhs,
+                                  const pool_tag_growth& rhs) {
+            const auto l = key(lhs), r = key(rhs);
+            return l > r || (l == r && lhs.tag < rhs.tag);
+        };
+
+        const auto p      = static_cast<std::size_t>(type);
+        const auto newest = _sample(0);
+        const auto oldest = _sample(window - 1);
+        const auto tags   = _tags.as<std::uint32_t>();
+        const auto first  = out.data();
+
+        std::size_t n = 0;
+        for(std::size_t row = 0; row < _rows; ++row) {
+            const auto& curr = newest[row];
+            const auto& prev = oldest[row];
+
+            // the unsigned differences stay correct when the counters wrap around
+            const pool_tag_growth g = {
+                tags[row],
+                static_cast<std::int64_t>(curr.used[p] - prev.used[p]),
+                static_cast<std::int32_t>((curr.allocations[p] - curr.frees[p]) -
+                                          (prev.allocations[p] - prev.frees[p]))
+            };
+
+            if(n < out.size()) {
+                first[n++] = g;
+                std::push_heap(first, first + n, better);
+            }
+            else if(better(g, *first)) {
+                std::pop_heap(first, first + n, better);
+                first[n - 1] = g;
+                std::push_heap(first, first + n, better);
+            }
+        }
+
+        std::sort_heap(first, first + n, better);
+        return n;
+    }
+
+    NTW_INLINE pool_tag_sampler::pool_tag_sampler(std::size_t history) noexcept
+        : _history(history < 2 ? 2 : history)
+    {}
+
+    NTW_INLINE status pool_tag_sampler::reserve(std::size_t tags) noexcept
+    {
+        return tags > _capacity ? _grow(tags) : STATUS_SUCCESS;
+    }
+
+    NTW_INLINE status pool_tag_sampler::sample() noexcept
+    {
+        std::span<system_pooltag> tags;
+
+        const auto s = ntw::detail::query_growing(
+            _query, initial_size, [&tags](auto& buffer, ulong_t* returned) {
+                const auto res = pool_tags(buffer.span(), returned);
+                if(res.success())
+                    tags = *res;
+                return res.status();
+            });
+        if(!s.success())
+            return s;
+
+        // every tag may be new, growing up front keeps the loop below infallible
+        if(_rows + tags.size() > _capacity) {
+            if(const auto gs = _grow(_rows + tags.size()); !gs.success())
+                return gs;
+        }
+
+        const auto sample = _ring.as<counters>() + _head * _capacity;
+        std::memset(sample, 0, _capacity * sizeof(counters));
+        for(const auto& t : tags) {
+            auto& c          = sample[_row(t.tag)];
+            c.used[0]        = t.paged_used;
+            c.allocations[0] = t.paged_allocations;
+            c.frees[0]       = t.paged_frees;
+            c.used[1]        = t.non_paged_used;
+            c.allocations[1] = t.non_paged_allocations;
+            c.frees[1]       = t.non_paged_frees;
+        }
+
+        _head = (_head + 1) % _history;
+        if(_count < _history)
+            ++_count;
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE std::size_t pool_tag_sampler::samples() const noexcept { return _count; }
+
+    NTW_INLINE std::size_t pool_tag_sampler::tags() const noexcept { return _rows; }
+
+    NTW_INLINE std::size_t pool_tag_sampler::top_used(pool_type                  type,
+                                                      std::span<pool_tag_growth> out,
+                                                      std::size_t window) const noexcept
+    {
+        return _top(type, out, window, [](const pool_tag_growth& g) { return g.used; });
+    }
+
+    NTW_INLINE std::size_t
+    pool_tag_sampler::top_outstanding(pool_type                  type,
+                                      std::span<pool_tag_growth> out,
+                                      std::size_t                window) const noexcept
+    {
+        return _top(
+            type, out, window, [](const pool_tag_growth& g) { return g.outstanding; });
+    }
+
+} // namespace ntw::sys
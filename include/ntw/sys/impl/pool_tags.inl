@@ -20,6 +20,14 @@
 namespace ntw::sys {
 
     static_assert(sizeof(system_pooltag) == sizeof(SYSTEM_POOLTAG));
+    static_assert(offsetof(system_pooltag, paged_allocations) ==
+                  offsetof(SYSTEM_POOLTAG, PagedAllocs));
+    static_assert(offsetof(system_pooltag, paged_used) ==
+                  offsetof(SYSTEM_POOLTAG, PagedUsed));
+    static_assert(offsetof(system_pooltag, non_paged_allocations) ==
+                  offsetof(SYSTEM_POOLTAG, NonPagedAllocs));
+    static_assert(offsetof(system_pooltag, non_paged_used) ==
+                  offsetof(SYSTEM_POOLTAG, NonPagedUsed));
 
     template<class Range>
     NTW_INLINE ::ntw::result<std::span<system_pooltag>>
@@ -0,0 +1,254 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../process_columns.hpp"
+
+namespace ntw::sys {
+
+    NTW_INLINE constexpr process_fields process_fields::all() noexcept
+    {
+        process_fields fields;
+        fields._fields = (1u << column_count) - 1;
+        return fields;
+    }
+
+    NTW_INLINE constexpr std::uint32_t process_fields::get() const noexcept
+    {
+        return _fields;
+    }
+
+    NTW_INLINE constexpr bool process_fields::has(column c) const noexcept
+    {
+        return _fields & (1u << c);
+    }
+
+#define NTW_PROCESS_FIELD(name)                                          \
+    NTW_INLINE constexpr process_fields& process_fields::name() noexcept \
+    {                                                                    \
+        _fields |= 1u << name##_column;                                  \
+        return *this;                                                    \
+    }
+
+    NTW_PROCESS_FIELD(id)
+    NTW_PROCESS_FIELD(parent_id)
+    NTW_PROCESS_FIELD(session_id)
+    NTW_PROCESS_FIELD(thread_count)
+    NTW_PROCESS_FIELD(handle_count)
+    NTW_PROCESS_FIELD(working_set_size)
+    NTW_PROCESS_FIELD(private_page_count)
+    NTW_PROCESS_FIELD(virtual_size)
+    NTW_PROCESS_FIELD(pagefile_usage)
+    NTW_PROCESS_FIELD(cycle_time)
+    NTW_PROCESS_FIELD(kernel_time)
+    NTW_PROCESS_FIELD(user_time)
+    NTW_PROCESS_FIELD(read_transfer)
+    NTW_PROCESS_FIELD(write_transfer)
+
+#undef NTW_PROCESS_FIELD
+
+    template<class T>
+    NTW_INLINE std::span<const T>
+    process_columns::_column(process_fields::column c) const noexcept
+    {
+        const auto column = static_cast<const T*>(_columns[c]);
+        return { column, column ? _size : 0 };
+    }
+
+    template<class T, class Value>
+    NTW_INLINE void process_columns::_set(process_fields::column c, Value value) noexcept
+    {
+        if(const auto column = static_cast<T*>(_columns[c]))
+            column[_size] = static_cast<T>(value);
+    }
+
+    NTW_INLINE std::size_t process_columns::_row_size() const noexcept
+    {
+        std::size_t size = 0;
+        for(std::uint32_t c = 0; c < process_fields::column_count; ++c)
+            if(_fields.has(static_cast<process_fields::column>(c)))
+                size += c < process_fields::first_u64_column ? 4 : 8;
+        return size;
+    }
+
+    NTW_INLINE void process_columns::_layout(std::uint8_t* base,
+                                             std::size_t   capacity) noexcept
+    {
+        // capacity is a multiple of 16 so every column stays 64 byte aligned
+        _capacity = capacity;
+        for(std::uint32_t c = 0; c < process_fields::column_count; ++c) {
+            if(!capacity || !_fields.has(static_cast<process_fields::column>(c))) {
+                _columns[c] = nullptr;
+                continue;
+            }
+
+            _columns[c] = base;
+            base += capacity * (c < process_fields::first_u64_column ? 4 : 8);
+        }
+    }
+
+    NTW_INLINE status process_columns::_grow() noexcept
+    {
+        const auto row_size = _row_size();
+        const auto capacity = _capacity ? _capacity * 2 : 1024;
+
+        ntw::detail::growable_buffer buffer;
+        if(const auto s = buffer.reserve(capacity * row_size); !s.success())
+            return s;
+
+        void* old[process_fields::column_count];
+        std::memcpy(old, _columns, sizeof(old));
+
+        _layout(buffer.data(), capacity);
+        for(std::uint32_t c = 0; c < process_fields::column_count; ++c)
+            if(_columns[c] && old[c])
+                std::memcpy(_columns[c],
+                            old[c],
+                            _size * (c < process_fields::first_u64_column ? 4 : 8));
+
+        // the old buffer is released together with the local
+        _buffer = std::move(buffer);
+        return STATUS_SUCCESS;
+    }
+
+    template<class Range>
+    NTW_INLINE status process_columns::assign(Range&&        range,
+                                              process_fields fields) noexcept
+    {
+        using column = process_fields::column;
+
+        _size   = 0;
+        _fields = fields;
+
+        const auto row_size = _row_size();
+        if(!row_size) {
+            for(auto it = std::begin(range); it != std::end(range); ++it)
+                ++_size;
+            _layout(nullptr, 0);
+            return STATUS_SUCCESS;
+        }
+
+        _layout(_buffer.data(), (_buffer.size() / row_size) & ~std::size_t{ 15 });
+
+        for(const auto& p : range) {
+            if(_size == _capacity) {
+                if(const auto s = _grow(); !s.success()) {
+                    _size = 0;
+                    return s;
+                }
+            }
+
+            _set<std::uint32_t>(column::id_column, p.id);
+            _set<std::uint32_t>(column::parent_id_column, p.parent_id);
+            _set<std::uint32_t>(column::session_id_column, p.session_id);
+            _set<std::uint32_t>(column::thread_count_column, p.thread_count);
+            _set<std::uint32_t>(column::handle_count_column, p.handle_count);
+            _set<std::uint64_t>(column::working_set_size_column, p.working_set_size);
+            _set<std::uint64_t>(column::private_page_count_column, p.private_page_count);
+            _set<std::uint64_t>(column::virtual_size_column, p.virtual_size);
+            _set<std::uint64_t>(column::pagefile_usage_column, p.pagefile_usage);
+            _set<std::uint64_t>(column::cycle_time_column, p.cycle_time);
+            _set<std::uint64_t>(column::kernel_time_column, p.kernel_time.count());
+            _set<std::uint64_t>(column::user_time_column, p.user_time.count());
+            _set<std::uint64_t>(column::read_transfer_column, p.transfer_count.read);
+            _set<std::uint64_t>(column::write_transfer_column, p.transfer_count.write);
+            ++_size;
+        }
+
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE std::size_t process_columns::size() const noexcept { return _size; }
+
+    NTW_INLINE bool process_columns::empty() const noexcept { return !_size; }
+
+    NTW_INLINE process_fields process_columns::fields() const noexcept { return _fields; }
+
+#define NTW_PROCESS_COLUMN(type, name)                                      \
+    NTW_INLINE std::span<const type> process_columns::name() const noexcept \
+    {                                                                       \
+        return _column<type>(process_fields::name##_column);                \
+    }
+
+    NTW_PROCESS_COLUMN(std::uint32_t, id)
+    NTW_PROCESS_COLUMN(std::uint32_t, parent_id)
+    NTW_PROCESS_COLUMN(std::uint32_t, session_id)
+    NTW_PROCESS_COLUMN(std::uint32_t, thread_count)
+    NTW_PROCESS_COLUMN(std::uint32_t, handle_count)
+    NTW_PROCESS_COLUMN(std::uint64_t, working_set_size)
+    NTW_PROCESS_COLUMN(std::uint64_t, private_page_count)
+    NTW_PROCESS_COLUMN(std::uint64_t, virtual_size)
+    NTW_PROCESS_COLUMN(std::uint64_t, pagefile_usage)
+    NTW_PROCESS_COLUMN(std::uint64_t, cycle_time)
+    NTW_PROCESS_COLUMN(std::uint64_t, kernel_time)
+    NTW_PROCESS_COLUMN(std::uint64_t, user_time)
+    NTW_PROCESS_COLUMN(std::uint64_t, read_transfer)
+    NTW_PROCESS_COLUMN(std::uint64_t, write_transfer)
+
+#undef NTW_PROCESS_COLUMN
+
+    NTW_INLINE std::uint64_t sum(std::span<const std::uint64_t> values) noexcept
+    {
+        return ntw::detail::simd::sum(values.data(), values.size());
+    }
+
+    NTW_INLINE std::uint64_t sum(std::span<const std::uint32_t> values) noexcept
+    {
+        return ntw::detail::simd::sum(values.data(), values.size());
+    }
+
+    NTW_INLINE std::uint64_t sum_where(std::span<const std::uint64_t> values,
+                                       std::span<const std::uint32_t> keys,
+                                       std::uint32_t                  key) noexcept
+    {
+        return ntw::detail::simd::sum_where(
+            values.data(), keys.data(), key, std::min(values.size(), keys.size()));
+    }
+
+    template<class T>
+    NTW_INLINE std::size_t top_n(std::span<const T>       values,
+                                 std::span<std::uint32_t> out) noexcept
+    {
+        const auto n = std::min(out.size(), values.size());
+        if(!n)
+            return 0;
+
+        // orders rows from the best to the worst, so the heap top is the worst row
+        const auto better = [values](std::uint32_t lhs, std::uint32_t rhs) {
+            return values[lhs] > values[rhs] || (values[lhs] == values[rhs] && lhs < rhs);
+        };
+
+        const auto first = out.data();
+        const auto last  = first + n;
+        for(std::uint32_t i = 0; i < n; ++i)
+            first[i] = i;
+        std::make_heap(first, last, better);
+
+        // rows are visited in increasing order so ties never replace the top
+        for(auto i = static_cast<std::uint32_t>(n); i < values.size(); ++i) {
+            if(values[i] <= values[*first])
+                continue;
+
+            std::pop_heap(first, last, better);
+            last[-1] = i;
+            std::push_heap(first, last, better);
+        }
+
+        std::sort_heap(first, last, better);
+        return n;
+    }
+
+} // namespace ntw::sys
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../process_diff.hpp"
+
+namespace ntw::sys {
+
+    template<class Process>
+    NTW_INLINE process_delta delta(const Process& prev, const Process& curr) noexcept
+    {
+        process_delta d;
+        d.kernel_time          = curr.kernel_time - prev.kernel_time;
+        d.user_time            = curr.user_time - prev.user_time;
+        d.cycle_time           = curr.cycle_time - prev.cycle_time;
+        d.transfer_count.read  = curr.transfer_count.read - prev.transfer_count.read;
+        d.transfer_count.write = curr.transfer_count.write - prev.transfer_count.write;
+        d.transfer_count.other = curr.transfer_count.other - prev.transfer_count.other;
+        return d;
+    }
+
+    NTW_INLINE thread_delta delta(const thread& prev, const thread& curr) noexcept
+    {
+        thread_delta d;
+        d.kernel_time      = curr.kernel_time - prev.kernel_time;
+        d.user_time        = curr.user_time - prev.user_time;
+        d.context_switches = curr.context_switches - prev.context_switches;
+        return d;
+    }
+
+    NTW_INLINE constexpr std::size_t process_differ::_hash(
+        std::uintptr_t id, std::uint64_t create_time) noexcept
+    {
+        const auto h = (static_cast<std::uint64_t>(id) ^ create_time) *
+                       0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+
+    NTW_INLINE status process_differ::_prepare(ntw::detail::growable_buffer& table,
+                                               std::size_t&                  mask,
+                                               std::size_t count) noexcept
+    {
+        // keep the load factor at or below 1/2
+        std::size_t capacity = 16;
+        while(capacity < count * 2)
+            capacity *= 2;
+
+        if(const auto s = table.reserve(capacity * sizeof(slot)); !s.success())
+            return s;
+
+        // the buffer may have grown past what we asked for
+        capacity = table.size() / sizeof(slot);
+        while(capacity & (capacity - 1))
+            capacity &= capacity - 1;
+
+        mask = capacity - 1;
+        std::memset(table.data(), 0, capacity * sizeof(slot));
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE void process_differ::_insert(slot*          table,
+                                            std::size_t    mask,
+                                            std::uintptr_t id,
+                                            std::uint64_t  create_time,
+                                            const void*    entry,
+                                            const void*    owner) noexcept
+    {
+        auto i = _hash(id, create_time) & mask;
+        while(table[i].entry)
+            i = (i + 1) & mask;
+
+        table[i] = { id, create_time, entry, owner, false };
+    }
+
+    NTW_INLINE process_differ::slot*
+    process_differ::_match(slot*          table,
+                           std::size_t    mask,
+                           std::uintptr_t id,
+                           std::uint64_t  create_time) noexcept
+    {
+        // duplicate keys (idle threads for example) are paired in insertion order
+        for(auto i = _hash(id, create_time) & mask; table[i].entry;
+            i      = (i + 1) & mask) {
+            auto& s = table[i];
+            if(!s.matched && s.id == id && s.create_time == create_time) {
+                s.matched = true;
+                return &s;
+            }
+        }
+        return nullptr;
+    }
+
+    template<class Range, class Visitor>
+    NTW_INLINE status process_differ::diff(const Range& previous,
+                                           const Range& current,
+                                           Visitor&&    visitor) noexcept
+    {
+        using process_type = std::remove_cvref_t<decltype(*previous.begin())>;
+        using thread_type =
+            std::remove_cvref_t<decltype(*previous.begin()->threads().data())>;
+
+        std::size_t process_count = 0, thread_count = 0;
+        for(const auto& p : previous) {
+            ++process_count;
+            thread_count += p.threads().size();
+        }
+
+        if(auto s = _prepare(_processes, _process_mask, process_count); !s.success())
+            return s;
+        if(auto s = _prepare(_threads, _thread_mask, thread_count); !s.success())
+            return s;
+
+        const auto processes = _processes.as<slot>();
+        const auto threads   = _threads.as<slot>();
+
+        for(const auto& p : previous) {
+            _insert(processes, _process_mask, p.id, p.create_time, &p, nullptr);
+            for(const auto& t : p.threads())
+                _insert(threads, _thread_mask, t.id, t.create_time, &t, &p);
+        }
+
+        for(const auto& p : current) {
+            const auto prev_slot = _match(processes, _process_mask, p.id, p.create_time);
+            if(prev_slot) {
+                if constexpr(requires {
+                                 visitor.process_changed(p, p, process_delta{});
+                             }) {
+                    const auto& prev =
+                        *static_cast<const process_type*>(prev_slot->entry);
+                    visitor.process_changed(prev, p, delta(prev, p));
+                }
+            }
+            else if constexpr(requires { visitor.process_created(p); })
+                visitor.process_created(p);
+
+            for(const auto& t : p.threads()) {
+                const auto prev_thread =
+                    _match(threads, _thread_mask, t.id, t.create_time);
+                if(prev_thread) {
+                    if constexpr(requires {
+                                     visitor.thread_changed(p, t, t, thread_delta{});
+                                 }) {
+                        const auto& prev =
+                            *static_cast<const thread_type*>(prev_thread->entry);
+                        visitor.thread_changed(p, prev, t, delta(prev, t));
+                    }
+                }
+                else if constexpr(requires { visitor.thread_created(p, t); })
+                    visitor.thread_created(p, t);
+            }
+        }
+
+        if constexpr(requires(const process_type& p) { visitor.process_exited(p); }) {
+            for(std::size_t i = 0; i <= _process_mask; ++i)
+                if(processes[i].entry && !processes[i].matched)
+                    visitor.process_exited(
+                        *static_cast<const process_type*>(processes[i].entry));
+        }
+
+        if constexpr(requires(const process_type& p, const thread_type& t) {
+                         visitor.thread_exited(p, t);
+                     }) {
+            for(std::size_t i = 0; i <= _thread_mask; ++i)
+                if(threads[i].entry && !threads[i].matched)
+                    visitor.thread_exited(
+                        *static_cast<const process_type*>(threads[i].owner),
+                        *static_cast<const thread_type*>(threads[i].entry));
+        }
+
+        return STATUS_SUCCESS;
+    }
+
+} // namespace ntw::sys
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../process_snapshot.hpp"
+
+namespace ntw::sys {
+
+    template<class Process>
+    NTW_INLINE status basic_process_snapshot<Process>::reserve(std::size_t size) noexcept
+    {
+        return _buffer.reserve(size);
+    }
+
+    template<class Process>
+    NTW_INLINE status basic_process_snapshot<Process>::refresh() noexcept
+    {
+        _used = 0;
+
+        ulong_t    used = 0;
+        const auto s    = ntw::detail::query_growing(
+            _buffer, initial_size, [&used](auto& buffer, ulong_t* returned) {
+                const auto res = query_processes<Process>(buffer.span(), returned);
+                used           = *returned;
+                return res.status();
+            });
+
+        if(s.success())
+            _used = used;
+        return s;
+    }
+
+    template<class Process>
+    NTW_INLINE typename basic_process_snapshot<Process>::range_type
+    basic_process_snapshot<Process>::range() const noexcept
+    {
+        return { _used ? _buffer.as<Process>() : nullptr };
+    }
+
+    template<class Process>
+    NTW_INLINE typename basic_process_snapshot<Process>::iterator
+    basic_process_snapshot<Process>::begin() const noexcept
+    {
+        return range().begin();
+    }
+
+    template<class Process>
+    NTW_INLINE typename basic_process_snapshot<Process>::iterator
+    basic_process_snapshot<Process>::end() const noexcept
+    {
+        return {};
+    }
+
+    template<class Process>
+    NTW_INLINE bool basic_process_snapshot<Process>::empty() const noexcept
+    {
+        return !_used;
+    }
+
+    template<class Process>
+    NTW_INLINE std::size_t basic_process_snapshot<Process>::used() const noexcept
+    {
+        return _used;
+    }
+
+    template<class Process>
+    NTW_INLINE std::size_t basic_process_snapshot<Process>::capacity() const noexcept
+    {
+        return _buffer.size();
+    }
+
+} // namespace ntw::sys
@@ -21,17 +21,49 @@ namespace ntw::sys {
     static_assert(sizeof(thread) == sizeof(SYSTEM_THREAD_INFORMATION));
     static_assert(sizeof(process) ==
                   (sizeof(SYSTEM_PROCESS_INFORMATION) - sizeof(thread)));
+    static_assert(sizeof(extended_thread) == sizeof(SYSTEM_EXTENDED_THREAD_INFORMATION));
+    static_assert(sizeof(extended_process) == sizeof(process));
+    static_assert(sizeof(full_process) == sizeof(process));
+    static_assert(sizeof(disk_counters) == sizeof(PROCESS_DISK_COUNTERS));
+    static_assert(offsetof(SYSTEM_PROCESS_INFORMATION_EXTENSION, ContextSwitches) ==
+                  offsetof(process_extension, context_switches));
+    static_assert(offsetof(SYSTEM_PROCESS_INFORMATION_EXTENSION, UserSidOffset) ==
+                  offsetof(process_extension, user_sid_offset));
+    static_assert(
+        offsetof(SYSTEM_PROCESS_INFORMATION_EXTENSION, PackageFullNameOffset) ==
+        offsetof(process_extension, package_full_name_offset));
 
-    template<class Range>
-    NTW_INLINE ntw::result<process::range_type> processes(Range&&  buffer,
-                                                          ulong_t* returned)
+    template<class Process, class Range>
+    NTW_INLINE ntw::result<typename Process::range_type>
+    query_processes(Range&& buffer, ulong_t* returned)
     {
         const auto  first  = detail::unfancy(detail::adl_begin(buffer));
         const auto  size   = static_cast<ulong_t>(detail::range_byte_size(buffer));
         ntw::status status = NTW_SYSCALL(NtQuerySystemInformation)(
-            SystemProcessInformation, first, size, returned);
+            Process::info_class, first, size, returned);
+
+        return { status, { reinterpret_cast<Process*>(first) } };
+    }
 
-        return { status, { reinterpret_cast<process*>(first) } };
+    template<class Range>
+    NTW_INLINE ntw::result<process::range_type> processes(Range&&  buffer,
+                                                          ulong_t* returned)
+    {
+        return query_processes<process>(buffer, returned);
+    }
+
+    template<class Range>
+    NTW_INLINE ntw::result<extended_process::range_type>
+    extended_processes(Range&& buffer, ulong_t* returned)
+    {
+        return query_processes<extended_process>(buffer, returned);
+    }
+
+    template<class Range>
+    NTW_INLINE ntw::result<full_process::range_type> full_processes(Range&&  buffer,
+                                                                    ulong_t* returned)
+    {
+        return query_processes<full_process>(buffer, returned);
     }
 
     NTW_INLINE std::span<thread> process::threads() noexcept
@@ -44,4 +76,39 @@ namespace ntw::sys {
         return { reinterpret_cast<const thread*>(this + 1), thread_count };
     }
 
+    NTW_INLINE std::span<extended_thread> extended_process::threads() noexcept
+    {
+        return { reinterpret_cast<extended_thread*>(this + 1), thread_count };
+    }
+
+    NTW_INLINE std::span<const extended_thread> extended_process::threads() const noexcept
+    {
+        return { reinterpret_cast<const extended_thread*>(this + 1), thread_count };
+    }
+
+    NTW_INLINE const process_extension& full_process::extension() const noexcept
+    {
+        return *reinterpret_cast<const process_extension*>(threads().data() +
+                                                           thread_count);
+    }
+
+    NTW_INLINE PSID full_process::user_sid() const noexcept
+    {
+        const auto offset = extension().user_sid_offset;
+        if(!offset)
+            return nullptr;
+
+        return const_cast<char*>(reinterpret_cast<const char*>(this) + offset);
+    }
+
+    NTW_INLINE const wchar_t* full_process::package_full_name() const noexcept
+    {
+        const auto offset = extension().package_full_name_offset;
+        if(!offset)
+            return nullptr;
+
+        return reinterpret_cast<const wchar_t*>(reinterpret_cast<const char*>(this) +
+                                                offset);
+    }
+
 } // namespace ntw::sys
\ No newline at end of file
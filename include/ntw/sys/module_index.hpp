@@ -0,0 +1,76 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "modules.hpp"
+#include <algorithm>
+
+namespace ntw::sys {
+
+    /// \brief The address range occupied by a loaded module.
+    struct module_interval {
+        std::uintptr_t       base;
+        std::size_t          size;
+        const loaded_module* module;
+    };
+
+    /// \brief Sorted array of module address ranges used to resolve addresses to the
+    ///        module containing them.
+    /// \note The index points into the module list it was built from, so it has to
+    ///       be rebuilt whenever that buffer is refreshed. The storage is kept between
+    ///       assignments.
+    class module_index {
+        ntw::detail::growable_buffer _buffer;
+        std::size_t                  _size = 0;
+
+    public:
+        /// \brief The amount of addresses that are searched for in lockstep by the
+        ///        batch find.
+        constexpr static std::size_t batch_size = 8;
+
+        NTW_INLINE module_index() noexcept = default;
+
+        /// \brief Records the ranges of modules, replacing the previous contents.
+        /// \param range The modules, for example the result of loaded_modules().
+        template<class Range>
+        NTW_INLINE status assign(Range&& range) noexcept;
+
+        NTW_INLINE std::size_t size() const noexcept;
+
+        NTW_INLINE bool empty() const noexcept;
+
+        /// \brief Returns the intervals sorted by their base address.
+        NTW_INLINE std::span<const module_interval> intervals() const noexcept;
+
+        /// \brief Returns the module which contains the address or nullptr.
+        NTW_INLINE const loaded_module* find(std::uintptr_t address) const noexcept;
+
+        /// \brief Returns the module which contains the address or nullptr.
+        NTW_INLINE const loaded_module* find(const void* address) const noexcept;
+
+        /// \brief Resolves many addresses at once. The searches are interleaved so the
+        ///        memory latency of one is hidden behind the others.
+        /// \param addresses The addresses to resolve.
+        /// \param modules Receives the module or nullptr for every address. Must be at
+        ///                least as large as addresses.
+        NTW_INLINE void find(std::span<const std::uintptr_t> addresses,
+                             std::span<const loaded_module*> modules) const noexcept;
+    };
+
+} // namespace ntw::sys
+
+#include "impl/module_index.inl"
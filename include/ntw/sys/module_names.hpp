@@ -0,0 +1,64 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "modules.hpp"
+
+namespace ntw::sys {
+
+    /// \brief Hash table of module file names for case insensitive lookups by name.
+    /// \note The table points into the module list it was built from, so it has to
+    ///       be rebuilt whenever that buffer is refreshed. The storage is kept between
+    ///       assignments.
+    class module_name_table {
+        struct slot {
+            std::uint32_t        hash;
+            std::uint32_t        length;
+            const loaded_module* module;
+        };
+
+        ntw::detail::growable_buffer _buffer;
+        std::size_t                  _mask = 0;
+        std::size_t                  _size = 0;
+
+        NTW_INLINE constexpr static char _fold(char c) noexcept;
+
+        NTW_INLINE constexpr static std::uint32_t _hash(std::string_view name) noexcept;
+
+        NTW_INLINE static bool _equal(const char* lhs, std::string_view rhs) noexcept;
+
+    public:
+        NTW_INLINE module_name_table() noexcept = default;
+
+        /// \brief Records the names of modules, replacing the previous contents.
+        /// \param range The modules, for example the result of loaded_modules().
+        template<class Range>
+        NTW_INLINE status assign(Range&& range) noexcept;
+
+        NTW_INLINE std::size_t size() const noexcept;
+
+        NTW_INLINE bool empty() const noexcept;
+
+        /// \brief Finds a module by its file name ignoring ASCII case.
+        /// \param name The file name without path, for example "ntoskrnl.exe".
+        /// \returns The first module with the name or nullptr.
+        NTW_INLINE const loaded_module* find(std::string_view name) const noexcept;
+    };
+
+} // namespace ntw::sys
+
+#include "impl/module_names.inl"
@@ -16,6 +16,7 @@
 
 #pragma once
 #include "../detail/offset_iterator.hpp"
+#include "../detail/simd.hpp"
 #include "../result.hpp"
 #include <string_view>
 
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "../detail/simd.hpp"
+#include "pool_tags.hpp"
+#include <string_view>
+
+namespace ntw::sys {
+
+    /// \brief A pool tag compared under a mask.
+    struct pool_tag_pattern {
+        std::uint32_t value = 0;
+        std::uint32_t mask  = 0;
+
+        NTW_INLINE constexpr pool_tag_pattern() = default;
+
+        NTW_INLINE constexpr pool_tag_pattern(std::uint32_t value,
+                                              std::uint32_t mask = 0xFFFFFFFF) noexcept;
+
+        /// \brief Parses a pattern such as "Nt*", "Ob?j" or "File".
+        /// \note '?' matches any single character and '*' matches the rest of tag.
+        ///       Characters missing from a pattern shorter than 4 characters without
+        ///       '*' match spaces, as short tags are padded with them.
+        NTW_INLINE constexpr pool_tag_pattern(std::string_view pattern) noexcept;
+
+        NTW_INLINE constexpr pool_tag_pattern(const char* pattern) noexcept;
+
+        /// \brief Checks whether the tag matches this pattern.
+        NTW_INLINE constexpr bool matches(std::uint32_t tag) const noexcept;
+    };
+
+    /// \brief A set of pool tag patterns which selects the matching entries of a pool
+    ///        tag array.
+    /// \note Works on any system_pooltag array, whether it is the result of
+    ///       pool_tags() or a previously recorded copy.
+    class pool_tag_filter {
+        // values[capacity] followed by masks[capacity]
+        ntw::detail::growable_buffer _patterns;
+        std::size_t                  _size     = 0;
+        std::size_t                  _capacity = 0;
+
+        NTW_INLINE const std::uint32_t* _values() const noexcept;
+
+        NTW_INLINE const std::uint32_t* _masks() const noexcept;
+
+    public:
+        /// \brief Pattern counts up to this are tested against 4 tags at a time,
+        ///        larger sets test each tag against 4 patterns at a time.
+        constexpr static std::size_t tag_lanes_limit = 4;
+
+        NTW_INLINE pool_tag_filter() noexcept = default;
+
+        /// \brief Adds a pattern to the set.
+        NTW_INLINE status add(pool_tag_pattern pattern) noexcept;
+
+        /// \brief Adds every pattern of the range to the set.
+        template<class Range>
+        NTW_INLINE status add_range(const Range& patterns) noexcept;
+
+        /// \brief Removes all patterns while keeping the storage.
+        NTW_INLINE void clear() noexcept;
+
+        NTW_INLINE std::size_t size() const noexcept;
+
+        NTW_INLINE bool empty() const noexcept;
+
+        /// \brief Checks whether the tag matches any pattern.
+        NTW_INLINE bool matches(std::uint32_t tag) const noexcept;
+
+        /// \brief Writes the indices of tags that match any pattern.
+        /// \param tags The tags to filter.
+        /// \param out Receives the indices in increasing order. Filtering stops once it
+        ///            is full, so it should be as large as tags.
+        /// \returns The amount of indices written.
+        NTW_INLINE std::size_t filter(std::span<const system_pooltag> tags,
+                                      std::span<std::uint32_t>        out) const noexcept;
+    };
+
+} // namespace ntw::sys
+
+#include "impl/pool_tag_filter.inl"
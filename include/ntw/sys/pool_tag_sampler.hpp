@@ -0,0 +1,124 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "pool_tags.hpp"
+#include <algorithm>
+
+namespace ntw::sys {
+
+    enum class pool_type : std::uint8_t { paged, non_paged };
+
+    /// \brief The change of a pool tag counters over a window of samples.
+    struct pool_tag_growth {
+        std::uint32_t tag;
+        std::int64_t  used; // change of used bytes
+        std::int64_t  outstanding; // change of allocations - frees
+    };
+
+    /// \brief Periodically samples pool tags into a ring of past samples to find
+    ///        the tags that keep growing.
+    /// \note Every tag gets a row on the first sample it appears in. The rows, the
+    ///       tag hash table and the ring only grow when new tags appear so steady
+    ///       state sampling does not allocate.
+    class pool_tag_sampler {
+        struct counters {
+            std::uint64_t used[2];
+            std::uint32_t allocations[2];
+            std::uint32_t frees[2];
+        };
+
+        struct slot {
+            std::uint32_t tag;
+            std::uint32_t row; // row + 1, 0 marks an empty slot
+        };
+
+        ntw::detail::growable_buffer _query;
+        ntw::detail::growable_buffer _tags; // row -> tag
+        ntw::detail::growable_buffer _table; // tag -> row
+        ntw::detail::growable_buffer _ring; // [history][capacity] of counters
+        std::size_t                  _history  = 0;
+        std::size_t                  _capacity = 0;
+        std::size_t                  _rows     = 0;
+        std::size_t                  _mask     = 0;
+        std::size_t                  _head     = 0;
+        std::size_t                  _count    = 0;
+
+        NTW_INLINE constexpr static std::size_t _hash(std::uint32_t tag) noexcept;
+
+        NTW_INLINE counters* _sample(std::size_t age) const noexcept;
+
+        NTW_INLINE void _insert(std::uint32_t tag, std::uint32_t row) const noexcept;
+
+        NTW_INLINE status _grow(std::size_t capacity) noexcept;
+
+        NTW_INLINE std::uint32_t _row(std::uint32_t tag) noexcept;
+
+        template<class Key>
+        NTW_INLINE std::size_t _top(pool_type                  type,
+                                    std::span<pool_tag_growth> out,
+                                    std::size_t                window,
+                                    Key                        key) const noexcept;
+
+    public:
+        /// \brief Window size which covers every stored sample.
+        constexpr static std::size_t all_samples = ~std::size_t{ 0 };
+
+        /// \brief The size of the first query buffer allocation.
+        constexpr static std::size_t initial_size = 0x40000;
+
+        /// \brief Constructs the sampler without allocating.
+        /// \param history The amount of samples kept in the ring, at least 2.
+        NTW_INLINE explicit pool_tag_sampler(std::size_t history = 60) noexcept;
+
+        /// \brief Preallocates the storage for the given amount of tags.
+        NTW_INLINE status reserve(std::size_t tags) noexcept;
+
+        /// \brief Queries the pool tags and records them as the newest sample,
+        ///        overwriting the oldest one if the ring is full.
+        NTW_INLINE status sample() noexcept;
+
+        /// \brief Returns the amount of samples currently stored.
+        NTW_INLINE std::size_t samples() const noexcept;
+
+        /// \brief Returns the amount of distinct tags seen so far.
+        NTW_INLINE std::size_t tags() const noexcept;
+
+        /// \brief Selects the tags with the largest growth of used bytes.
+        /// \param type The pool to rank by.
+        /// \param out Receives up to out.size() tags ordered from the largest growth.
+        /// \param window The amount of samples to look back over, clamped to samples().
+        /// \returns The amount of entries written.
+        NTW_INLINE std::size_t
+        top_used(pool_type                  type,
+                 std::span<pool_tag_growth> out,
+                 std::size_t                window = all_samples) const noexcept;
+
+        /// \brief Selects the tags with the largest growth of allocations - frees.
+        /// \param type The pool to rank by.
+        /// \param out Receives up to out.size() tags ordered from the largest growth.
+        /// \param window The amount of samples to look back over, clamped to samples().
+        /// \returns The amount of entries written.
+        NTW_INLINE std::size_t
+        top_outstanding(pool_type                  type,
+                        std::span<pool_tag_growth> out,
+                        std::size_t                window = all_samples) const noexcept;
+    };
+
+} // namespace ntw::sys
+
+#include "impl/pool_tag_sampler.inl"
@@ -19,13 +19,17 @@
 
 namespace ntw::sys {
 
+    /// \brief A wrapper around SYSTEM_POOLTAG class
+    /// \note The counters are not grouped into per pool structs because the 8 byte
+    ///       alignment of such struct would not match the native x64 layout.
     struct system_pooltag {
         std::uint32_t tag;
-        struct {
-            std::uint32_t allocations;
-            std::uint32_t frees;
-            std::size_t   used;
-        } paged, non_paged;
+        std::uint32_t paged_allocations; // PagedAllocs
+        std::uint32_t paged_frees; // PagedFrees
+        std::size_t   paged_used; // PagedUsed
+        std::uint32_t non_paged_allocations; // NonPagedAllocs
+        std::uint32_t non_paged_frees; // NonPagedFrees
+        std::size_t   non_paged_used; // NonPagedUsed
     };
 
     /// \brief Queries pool tags in system use using SystemPoolTagInformation class.
@@ -0,0 +1,199 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "../detail/simd.hpp"
+#include "processes.hpp"
+#include <algorithm>
+
+namespace ntw::sys {
+
+    /// \brief Selects which process fields are copied by process_columns.
+    class process_fields {
+        std::uint32_t _fields = 0;
+
+    public:
+        enum column : std::uint32_t {
+            // 32 bit columns
+            id_column,
+            parent_id_column,
+            session_id_column,
+            thread_count_column,
+            handle_count_column,
+            // 64 bit columns
+            working_set_size_column,
+            private_page_count_column,
+            virtual_size_column,
+            pagefile_usage_column,
+            cycle_time_column,
+            kernel_time_column,
+            user_time_column,
+            read_transfer_column,
+            write_transfer_column,
+            column_count,
+            first_u64_column = working_set_size_column
+        };
+
+        NTW_INLINE constexpr process_fields() = default;
+
+        /// \brief Returns the selection with every field enabled.
+        NTW_INLINE constexpr static process_fields all() noexcept;
+
+        /// \brief Returns the raw bitmask of enabled columns.
+        NTW_INLINE constexpr std::uint32_t get() const noexcept;
+
+        /// \brief Checks whether the given column is enabled.
+        NTW_INLINE constexpr bool has(column c) const noexcept;
+
+        /// \brief Enables UniqueProcessId column. Process ids fit in 32 bits.
+        NTW_INLINE constexpr process_fields& id() noexcept;
+
+        /// \brief Enables InheritedFromUniqueProcessId column.
+        NTW_INLINE constexpr process_fields& parent_id() noexcept;
+
+        /// \brief Enables SessionId column.
+        NTW_INLINE constexpr process_fields& session_id() noexcept;
+
+        /// \brief Enables NumberOfThreads column.
+        NTW_INLINE constexpr process_fields& thread_count() noexcept;
+
+        /// \brief Enables HandleCount column.
+        NTW_INLINE constexpr process_fields& handle_count() noexcept;
+
+        /// \brief Enables WorkingSetSize column.
+        NTW_INLINE constexpr process_fields& working_set_size() noexcept;
+
+        /// \brief Enables PrivatePageCount column.
+        NTW_INLINE constexpr process_fields& private_page_count() noexcept;
+
+        /// \brief Enables VirtualSize column.
+        NTW_INLINE constexpr process_fields& virtual_size() noexcept;
+
+        /// \brief Enables PagefileUsage column.
+        NTW_INLINE constexpr process_fields& pagefile_usage() noexcept;
+
+        /// \brief Enables CycleTime column.
+        NTW_INLINE constexpr process_fields& cycle_time() noexcept;
+
+        /// \brief Enables KernelTime column. Stored in 100ns ticks.
+        NTW_INLINE constexpr process_fields& kernel_time() noexcept;
+
+        /// \brief Enables UserTime column. Stored in 100ns ticks.
+        NTW_INLINE constexpr process_fields& user_time() noexcept;
+
+        /// \brief Enables ReadTransferCount column.
+        NTW_INLINE constexpr process_fields& read_transfer() noexcept;
+
+        /// \brief Enables WriteTransferCount column.
+        NTW_INLINE constexpr process_fields& write_transfer() noexcept;
+    };
+
+    /// \brief Columnar copy of the selected fields of a process list. Every column is a
+    ///        contiguous 64 byte aligned array so that aggregations over it can be
+    ///        vectorized instead of walking the linked process entries.
+    /// \note The storage is kept between assignments. Columns that were not selected
+    ///       are returned as empty spans.
+    class process_columns {
+        ntw::detail::growable_buffer _buffer;
+        std::size_t                  _size     = 0;
+        std::size_t                  _capacity = 0;
+        process_fields               _fields;
+        void*                        _columns[process_fields::column_count] = {};
+
+        template<class T>
+        NTW_INLINE std::span<const T> _column(process_fields::column c) const noexcept;
+
+        template<class T, class Value>
+        NTW_INLINE void _set(process_fields::column c, Value value) noexcept;
+
+        NTW_INLINE std::size_t _row_size() const noexcept;
+
+        NTW_INLINE void _layout(std::uint8_t* base, std::size_t capacity) noexcept;
+
+        NTW_INLINE status _grow() noexcept;
+
+    public:
+        NTW_INLINE process_columns() noexcept = default;
+
+        /// \brief Copies the selected fields of every process in range, replacing the
+        ///        previous contents.
+        /// \param range The processes, for example process_snapshot or processes().
+        /// \param fields The columns to fill.
+        template<class Range>
+        NTW_INLINE status assign(Range&& range, process_fields fields) noexcept;
+
+        /// \brief Returns the amount of rows.
+        NTW_INLINE std::size_t size() const noexcept;
+
+        NTW_INLINE bool empty() const noexcept;
+
+        /// \brief Returns the selection used by the last assignment.
+        NTW_INLINE process_fields fields() const noexcept;
+
+        NTW_INLINE std::span<const std::uint32_t> id() const noexcept;
+
+        NTW_INLINE std::span<const std::uint32_t> parent_id() const noexcept;
+
+        NTW_INLINE std::span<const std::uint32_t> session_id() const noexcept;
+
+        NTW_INLINE std::span<const std::uint32_t> thread_count() const noexcept;
+
+        NTW_INLINE std::span<const std::uint32_t> handle_count() const noexcept;
+
+        NTW_INLINE std::span<const std::uint64_t> working_set_size() const noexcept;
+
+        NTW_INLINE std::span<const std::uint64_t> private_page_count() const noexcept;
+
+        NTW_INLINE std::span<const std::uint64_t> virtual_size() const noexcept;
+
+        NTW_INLINE std::span<const std::uint64_t> pagefile_usage() const noexcept;
+
+        NTW_INLINE std::span<const std::uint64_t> cycle_time() const noexcept;
+
+        NTW_INLINE std::span<const std::uint64_t> kernel_time() const noexcept;
+
+        NTW_INLINE std::span<const std::uint64_t> user_time() const noexcept;
+
+        NTW_INLINE std::span<const std::uint64_t> read_transfer() const noexcept;
+
+        NTW_INLINE std::span<const std::uint64_t> write_transfer() const noexcept;
+    };
+
+    /// \brief Returns the sum of a column.
+    NTW_INLINE std::uint64_t sum(std::span<const std::uint64_t> values) noexcept;
+
+    /// \brief Returns the sum of a column.
+    NTW_INLINE std::uint64_t sum(std::span<const std::uint32_t> values) noexcept;
+
+    /// \brief Returns the sum of values in rows where keys[row] == key.
+    /// \note Used for grouped queries, such as private pages of a session.
+    NTW_INLINE std::uint64_t sum_where(std::span<const std::uint64_t> values,
+                                       std::span<const std::uint32_t> keys,
+                                       std::uint32_t                  key) noexcept;
+
+    /// \brief Selects the rows with the largest values.
+    /// \param values The column to rank by.
+    /// \param out Receives up to out.size() row indices ordered from the largest value.
+    ///            Equal values are ordered by their row index.
+    /// \returns The amount of indices written.
+    template<class T>
+    NTW_INLINE std::size_t top_n(std::span<const T>       values,
+                                 std::span<std::uint32_t> out) noexcept;
+
+} // namespace ntw::sys
+
+#include "impl/process_columns.inl"
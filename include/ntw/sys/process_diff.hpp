@@ -0,0 +1,114 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "processes.hpp"
+
+namespace ntw::sys {
+
+    /// \brief The change of process counters between two snapshots.
+    struct process_delta {
+        duration      kernel_time;
+        duration      user_time;
+        std::uint64_t cycle_time;
+
+        struct {
+            std::uint64_t read;
+            std::uint64_t write;
+            std::uint64_t other;
+        } transfer_count;
+    };
+
+    /// \brief The change of thread counters between two snapshots.
+    struct thread_delta {
+        duration      kernel_time;
+        duration      user_time;
+        std::uint32_t context_switches;
+    };
+
+    /// \brief Matches processes and threads of two snapshots using (id, create_time)
+    ///        keys and reports what was created, what exited and how counters changed.
+    /// \note The hash tables are kept between calls so diffing two reused snapshot
+    ///       buffers does not allocate once the tables are large enough.
+    ///
+    /// The visitor may implement any subset of the following member functions:
+    ///   process_created(const Process&)
+    ///   process_exited(const Process&)
+    ///   process_changed(const Process& prev, const Process& curr, const process_delta&)
+    ///   thread_created(const Process&, const Thread&)
+    ///   thread_exited(const Process&, const Thread&)
+    ///   thread_changed(const Process&, const Thread& prev, const Thread& curr,
+    ///                  const thread_delta&)
+    /// Threads of created and exited processes are reported as created and exited.
+    /// Exited entities are reported after everything else in an unspecified order.
+    class process_differ {
+        struct slot {
+            std::uintptr_t id;
+            std::uint64_t  create_time;
+            const void*    entry;
+            const void*    owner;
+            bool           matched;
+        };
+
+        ntw::detail::growable_buffer _processes;
+        ntw::detail::growable_buffer _threads;
+        std::size_t                  _process_mask = 0;
+        std::size_t                  _thread_mask  = 0;
+
+        NTW_INLINE constexpr static std::size_t
+        _hash(std::uintptr_t id, std::uint64_t create_time) noexcept;
+
+        NTW_INLINE static status _prepare(ntw::detail::growable_buffer& table,
+                                          std::size_t&                  mask,
+                                          std::size_t                   count) noexcept;
+
+        NTW_INLINE static void _insert(slot*          table,
+                                       std::size_t    mask,
+                                       std::uintptr_t id,
+                                       std::uint64_t  create_time,
+                                       const void*    entry,
+                                       const void*    owner) noexcept;
+
+        NTW_INLINE static slot* _match(slot*          table,
+                                       std::size_t    mask,
+                                       std::uintptr_t id,
+                                       std::uint64_t  create_time) noexcept;
+
+    public:
+        NTW_INLINE process_differ() noexcept = default;
+
+        /// \brief Compares two snapshots and reports the differences to visitor.
+        /// \param previous The older snapshot.
+        /// \param current The newer snapshot.
+        /// \param visitor The object that receives the differences.
+        /// \note Both snapshots must stay alive for the duration of the call.
+        template<class Range, class Visitor>
+        NTW_INLINE status diff(const Range& previous,
+                               const Range& current,
+                               Visitor&&    visitor) noexcept;
+    };
+
+    /// \brief Computes the change of counters from prev to curr.
+    template<class Process>
+    NTW_INLINE process_delta delta(const Process& prev, const Process& curr) noexcept;
+
+    /// \brief Computes the change of counters from prev to curr.
+    NTW_INLINE thread_delta delta(const thread& prev, const thread& curr) noexcept;
+
+} // namespace ntw::sys
+
+#include "impl/process_diff.inl"
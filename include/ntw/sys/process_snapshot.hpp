@@ -0,0 +1,73 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "processes.hpp"
+
+namespace ntw::sys {
+
+    /// \brief Owns the buffer that processes() is queried into. The buffer is grown
+    ///        geometrically on STATUS_INFO_LENGTH_MISMATCH and kept between refreshes
+    ///        so that polling does not allocate once the buffer is large enough.
+    /// \tparam Process One of process, extended_process or full_process.
+    template<class Process>
+    class basic_process_snapshot {
+        ntw::detail::growable_buffer _buffer;
+        ulong_t                      _used = 0;
+
+    public:
+        using range_type = typename Process::range_type;
+        using iterator   = typename range_type::iterator_type;
+
+        /// \brief The size of the first allocation if reserve was not called.
+        constexpr static std::size_t initial_size = 0x40000;
+
+        /// \brief Constructs an empty snapshot without allocating.
+        NTW_INLINE basic_process_snapshot() noexcept = default;
+
+        /// \brief Preallocates the internal buffer.
+        /// \param size The size of buffer in bytes.
+        NTW_INLINE status reserve(std::size_t size) noexcept;
+
+        /// \brief Queries the current list of processes into the owned buffer.
+        /// \note On failure the snapshot becomes empty.
+        NTW_INLINE status refresh() noexcept;
+
+        /// \brief Returns the range of processes from the last successful refresh.
+        NTW_INLINE range_type range() const noexcept;
+
+        NTW_INLINE iterator begin() const noexcept;
+
+        NTW_INLINE iterator end() const noexcept;
+
+        /// \brief Checks whether the snapshot contains no processes.
+        NTW_INLINE bool empty() const noexcept;
+
+        /// \brief Returns the amount of bytes used by the last refresh.
+        NTW_INLINE std::size_t used() const noexcept;
+
+        /// \brief Returns the size of owned buffer in bytes.
+        NTW_INLINE std::size_t capacity() const noexcept;
+    };
+
+    using process_snapshot          = basic_process_snapshot<process>;
+    using extended_process_snapshot = basic_process_snapshot<extended_process>;
+    using full_process_snapshot     = basic_process_snapshot<full_process>;
+
+} // namespace ntw::sys
+
+#include "impl/process_snapshot.inl"
@@ -91,7 +91,72 @@ namespace ntw::sys {
         /// \brief Returns a span of this process thread information
         NTW_INLINE std::span<const thread> threads() const noexcept;
 
-        using range_type = detail::offset_iterator_range<process, true>;
+        using range_type  = detail::offset_iterator_range<process, true>;
+        using thread_type = thread;
+
+        constexpr static auto info_class = SystemProcessInformation;
+    };
+
+    /// \brief A wrapper around SYSTEM_EXTENDED_THREAD_INFORMATION class
+    struct extended_thread : thread {
+        void*          stack_base;
+        void*          stack_limit;
+        void*          win32_start_address;
+        void*          teb_base;
+        std::uintptr_t reserved[3];
+    };
+
+    /// \brief A wrapper around SYSTEM_PROCESS_INFORMATION class as returned by
+    ///        SystemExtendedProcessInformation.
+    /// \note Only the type of thread entries differs from process.
+    struct extended_process : process {
+        /// \brief Returns a span of this process thread information
+        NTW_INLINE std::span<extended_thread> threads() noexcept;
+
+        /// \brief Returns a span of this process thread information
+        NTW_INLINE std::span<const extended_thread> threads() const noexcept;
+
+        using range_type  = detail::offset_iterator_range<extended_process, true>;
+        using thread_type = extended_thread;
+
+        constexpr static auto info_class = SystemExtendedProcessInformation;
+    };
+
+    /// \brief A wrapper around PROCESS_DISK_COUNTERS class
+    struct disk_counters {
+        std::uint64_t bytes_read;
+        std::uint64_t bytes_written;
+        std::uint64_t read_operation_count;
+        std::uint64_t write_operation_count;
+        std::uint64_t flush_operation_count;
+    };
+
+    /// \brief A wrapper around the stable beginning of
+    ///        SYSTEM_PROCESS_INFORMATION_EXTENSION class.
+    struct process_extension {
+        disk_counters disk;
+        std::uint64_t context_switches;
+        std::uint32_t flags;
+        std::uint32_t user_sid_offset;
+        std::uint32_t package_full_name_offset;
+    };
+
+    /// \brief A wrapper around SYSTEM_PROCESS_INFORMATION class as returned by
+    ///        SystemFullProcessInformation, where the extension follows the threads.
+    struct full_process : extended_process {
+        /// \brief Returns the extension which follows the thread information.
+        NTW_INLINE const process_extension& extension() const noexcept;
+
+        /// \brief Returns the sid of user the process runs as or nullptr.
+        NTW_INLINE PSID user_sid() const noexcept;
+
+        /// \brief Returns the package full name or nullptr if the process is not
+        ///        packaged.
+        NTW_INLINE const wchar_t* package_full_name() const noexcept;
+
+        using range_type = detail::offset_iterator_range<full_process, true>;
+
+        constexpr static auto info_class = SystemFullProcessInformation;
     };
 
     /// \brief Acquires a list of processes using NtQuerySystemInformation with
@@ -102,6 +167,28 @@ namespace ntw::sys {
     NTW_INLINE ntw::result<process::range_type> processes(Range&&  buffer,
                                                           ulong_t* returned = nullptr);
 
+    /// \brief Acquires a list of processes using NtQuerySystemInformation with
+    ///        SystemExtendedProcessInformation class.
+    /// \param buffer Buffer into which process information will be read into.
+    /// \param returned The amount of bytes used inside the buffer.
+    template<class Range>
+    NTW_INLINE ntw::result<extended_process::range_type>
+    extended_processes(Range&& buffer, ulong_t* returned = nullptr);
+
+    /// \brief Acquires a list of processes using NtQuerySystemInformation with
+    ///        SystemFullProcessInformation class.
+    /// \param buffer Buffer into which process information will be read into.
+    /// \param returned The amount of bytes used inside the buffer.
+    template<class Range>
+    NTW_INLINE ntw::result<full_process::range_type>
+    full_processes(Range&& buffer, ulong_t* returned = nullptr);
+
+    /// \brief Acquires a list of processes using the information class of Process.
+    /// \tparam Process One of process, extended_process or full_process.
+    template<class Process, class Range>
+    NTW_INLINE ntw::result<typename Process::range_type>
+    query_processes(Range&& buffer, ulong_t* returned = nullptr);
+
 } // namespace ntw::sys
 
 #include "impl/processes.inl"
\ No newline at end of file
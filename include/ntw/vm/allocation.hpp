@@ -28,6 +28,12 @@ namespace ntw::vm {
         std::size_t   _zero    = 0;
         std::uint32_t _type    = 0;
 
+        template<class Process>
+        NTW_INLINE result<void*> _allocate(std::size_t    size,
+                                           std::uint32_t  type,
+                                           protection     prot,
+                                           const Process& process) const noexcept;
+
     public:
         /// \brief Construct allocation_builder with nothing set.
         NTW_INLINE constexpr allocation_builder() noexcept = default;
@@ -88,16 +94,18 @@ namespace ntw::vm {
         /// \returns *this
         NTW_INLINE constexpr allocation_builder& large_pages() noexcept;
 
-        // TODO NtAllocateVirtualMemoryEx equivalent of this
-        /// \brief Enables MEM_REPLACE_PLACEHOLDER flag on this object.
-        /// \note Valid only for NtAllocateVirtualMemoryEx
+        /// \brief Enables MEM_REPLACE_PLACEHOLDER type flag. The allocation must cover
+        ///        a whole placeholder previously split with vm::split_placeholder.
+        /// \note Allocates using NtAllocateVirtualMemoryEx which ignores zero_bits.
         /// \returns *this
-        /// NTW_INLINE constexpr alloc_flags& replace_placeholder() noexcept;
+        NTW_INLINE constexpr allocation_builder& replace_placeholder() noexcept;
 
-        /// \brief Enables MEM_RESERVE_PLACEHOLDER flag on this object.
-        /// \note Valid only for NtAllocateVirtualMemoryEx
+        /// \brief Enables MEM_RESERVE_PLACEHOLDER type flag. Placeholders are reserved
+        ///        ranges that can later be replaced by allocations or mapped views.
+        /// \note Allocates using NtAllocateVirtualMemoryEx which ignores zero_bits. Only
+        ///       valid with reserve and PAGE_NOACCESS protection.
         /// \returns *this
-        /// NTW_INLINE constexpr alloc_flags& reserve_placeholder() noexcept;
+        NTW_INLINE constexpr allocation_builder& reserve_placeholder() noexcept;
     };
 
     NTW_INLINE constexpr allocation_builder allocate() noexcept;
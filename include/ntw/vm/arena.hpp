@@ -0,0 +1,124 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "allocation.hpp"
+#include "operation.hpp"
+#include <algorithm>
+#include <cstddef>
+
+namespace ntw::vm {
+
+    /// \brief Bump allocator over a single reserved range of address space. Memory is
+    ///        committed in chunks as the allocations advance and stays committed when
+    ///        the arena is rewound, so repeated passes do not fault in new pages.
+    ///
+    /// arena a;
+    /// a.chunk_size(0x100000).guard_pages();
+    /// a.reserve(0x10000000);
+    /// auto p = a.allocate(size);
+    /// \note With guard pages every chunk is followed by an uncommitted page so
+    ///       overruns fault instead of corrupting the next chunk. Allocations then
+    ///       never span chunks.
+    class arena {
+        struct chunk {
+            std::size_t begin;
+            std::size_t size;
+        };
+
+        std::uint8_t*                _base       = nullptr;
+        std::size_t                  _reserved   = 0;
+        std::size_t                  _offset     = 0;
+        std::size_t                  _limit      = 0; // end of the current chunk
+        std::size_t                  _high       = 0; // end of committed memory
+        std::size_t                  _chunk_size = 0x10000;
+        bool                         _guard      = false;
+        ntw::detail::growable_buffer _chunks; // committed chunks in guarded mode
+        std::size_t                  _chunk_count = 0;
+        std::size_t                  _chunk       = 0; // amount of chunks in use
+
+        NTW_INLINE chunk* _chunk_list() const noexcept;
+
+        NTW_INLINE std::size_t _align(std::size_t offset,
+                                      std::size_t alignment) const noexcept;
+
+        NTW_INLINE status _commit(std::size_t begin, std::size_t size) noexcept;
+
+        NTW_INLINE status _grow(std::size_t size, std::size_t alignment) noexcept;
+
+        NTW_INLINE status _grow_guarded(std::size_t size, std::size_t alignment) noexcept;
+
+    public:
+        constexpr static std::size_t page_size = 0x1000;
+
+        NTW_INLINE arena() noexcept = default;
+
+        NTW_INLINE ~arena() noexcept;
+
+        NTW_INLINE arena(arena&& other) noexcept;
+
+        NTW_INLINE arena& operator=(arena&& other) noexcept;
+
+        /// \brief Sets the minimum amount of bytes committed at once. Rounded up to
+        ///        pages.
+        /// \note Must be called before reserve.
+        NTW_INLINE arena& chunk_size(std::size_t size) noexcept;
+
+        /// \brief Places an uncommitted page after every chunk.
+        /// \note Must be called before reserve.
+        NTW_INLINE arena& guard_pages() noexcept;
+
+        /// \brief Reserves the address space, releasing the previous range.
+        /// \param size The maximum amount of bytes in the arena, rounded up to pages.
+        NTW_INLINE status reserve(std::size_t size) noexcept;
+
+        /// \brief Allocates memory from the arena, committing more of it if needed.
+        /// \param size The size of allocation.
+        /// \param alignment The alignment of allocation, must be a power of 2.
+        /// \returns The allocation or STATUS_NO_MEMORY if the reserved range is full.
+        NTW_INLINE result<void*>
+                   allocate(std::size_t size,
+                            std::size_t alignment = alignof(std::max_align_t)) noexcept;
+
+        /// \brief Frees every allocation while keeping the memory committed and
+        ///        its contents intact.
+        NTW_INLINE void rewind() noexcept;
+
+        /// \brief Frees every allocation and marks the committed memory with
+        ///        vm::reset so its physical pages can be reused without being
+        ///        written out. The memory stays committed.
+        NTW_INLINE status reset() noexcept;
+
+        /// \brief Frees every allocation and decommits the memory with vm::decommit.
+        NTW_INLINE status decommit() noexcept;
+
+        /// \brief Returns the amount of bytes up to the end of the last allocation.
+        NTW_INLINE std::size_t used() const noexcept;
+
+        /// \brief Returns the amount of bytes up to the end of committed memory.
+        NTW_INLINE std::size_t committed() const noexcept;
+
+        /// \brief Returns the size of reserved range.
+        NTW_INLINE std::size_t reserved() const noexcept;
+
+        /// \brief Returns the beginning of reserved range.
+        NTW_INLINE void* data() const noexcept;
+    };
+
+} // namespace ntw::vm
+
+#include "impl/arena.inl"
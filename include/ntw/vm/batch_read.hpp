@@ -0,0 +1,70 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "../detail/unwrap.hpp"
+#include <algorithm>
+
+namespace ntw::vm {
+
+    /// \brief A single read of a batch. status receives the result of the read.
+    struct read_request {
+        std::uintptr_t address;
+        void*          buffer;
+        std::size_t    size;
+        ntw::status    status = STATUS_SUCCESS;
+    };
+
+    /// \brief Reads many small ranges of memory of a process with as few syscalls as
+    ///        possible. Requests are sorted by address and the pages they touch are
+    ///        merged into runs which are read with a single call each and then copied
+    ///        into the request buffers.
+    /// \note The reader keeps its buffers between batches so it should be reused.
+    class batch_reader {
+        ntw::detail::growable_buffer _order;
+        ntw::detail::growable_buffer _staging;
+        ntw::detail::growable_buffer _pages;
+
+        NTW_INLINE status _read_run(void*                   process,
+                                    std::span<read_request> requests,
+                                    const std::uint32_t*    first,
+                                    const std::uint32_t*    last,
+                                    std::uintptr_t          begin,
+                                    std::uintptr_t          end) noexcept;
+
+    public:
+        constexpr static std::size_t page_size = 0x1000;
+
+        /// \brief Requests of at least this size are read straight into their buffer.
+        constexpr static std::size_t direct_read_size = 0x10000;
+
+        NTW_INLINE batch_reader() noexcept = default;
+
+        /// \brief Performs every read of the batch.
+        /// \param requests The reads to perform. Their status is set to the status of
+        ///                 the read of the first unreadable page they touch.
+        /// \returns STATUS_SUCCESS if all requests succeeded, STATUS_PARTIAL_COPY if
+        ///          some of them failed or the status of failed allocation.
+        /// \note Buffers of failed requests may be partially written to.
+        template<class Process = void*>
+        NTW_INLINE status read(std::span<read_request> requests,
+                               const Process& process = NtCurrentProcess()) noexcept;
+    };
+
+} // namespace ntw::vm
+
+#include "impl/batch_read.inl"
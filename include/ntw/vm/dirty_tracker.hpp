@@ -0,0 +1,86 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "../detail/unwrap.hpp"
+#include <span>
+
+namespace ntw::vm {
+
+    /// \brief Reports the pages of a region written to since the last checkpoint
+    ///        using write watching, so only those need to be copied.
+    ///
+    /// auto mem = allocate().write_watch().commit_reserve(size);
+    /// dirty_tracker tracker(*mem, size);
+    /// // every checkpoint
+    /// for(auto page : *tracker.dirty_pages())
+    ///     copy(page, dirty_tracker::page_size);
+    /// \note The region must be allocated with allocation_builder::write_watch and
+    ///       begin on a page boundary.
+    class dirty_tracker {
+        std::uint8_t*                _base = nullptr;
+        std::size_t                  _size = 0;
+        ntw::detail::growable_buffer _pages;
+        ntw::detail::growable_buffer _bitmap;
+
+        template<class Process>
+        NTW_INLINE result<std::size_t> _query(bool           reset,
+                                              const Process& process) noexcept;
+
+    public:
+        constexpr static std::size_t page_size = 0x1000;
+
+        NTW_INLINE dirty_tracker() noexcept = default;
+
+        /// \brief Constructs tracker over the region [address, address + size).
+        template<class Address>
+        NTW_INLINE dirty_tracker(Address address, std::size_t size) noexcept;
+
+        /// \brief Returns the addresses of pages written to in ascending order.
+        /// \param reset Whether the pages are marked clean by the same call, which
+        ///              makes this the next checkpoint.
+        template<class Process = void*>
+        NTW_INLINE result<std::span<void* const>>
+                   dirty_pages(bool           reset   = true,
+                               const Process& process = NtCurrentProcess()) noexcept;
+
+        /// \brief Returns a bitmap of the region in which bit i of word i / 64 is set if
+        ///        page i was written to.
+        /// \param reset Whether the pages are marked clean by the same call, which
+        ///              makes this the next checkpoint.
+        template<class Process = void*>
+        NTW_INLINE result<std::span<const std::uint64_t>>
+                   dirty_bitmap(bool           reset   = true,
+                                const Process& process = NtCurrentProcess()) noexcept;
+
+        /// \brief Marks every page of the region clean.
+        template<class Process = void*>
+        NTW_INLINE status reset(const Process& process = NtCurrentProcess()) noexcept;
+
+        /// \brief Returns the amount of pages in the region.
+        NTW_INLINE std::size_t page_count() const noexcept;
+
+        /// \brief Returns the beginning of the region.
+        NTW_INLINE void* data() const noexcept;
+
+        /// \brief Returns the size of the region.
+        NTW_INLINE std::size_t size() const noexcept;
+    };
+
+} // namespace ntw::vm
+
+#include "impl/dirty_tracker.inl"
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "range.hpp"
+#include "../status.hpp"
+#include <span>
+
+namespace ntw::vm {
+
+    /// \brief Priority of pages on the standby list. Pages of lower priority are
+    ///        repurposed first when the system runs low on memory.
+    enum class page_priority : unsigned long {
+        lowest       = MEMORY_PRIORITY_LOWEST,
+        very_low     = MEMORY_PRIORITY_VERY_LOW,
+        low          = MEMORY_PRIORITY_LOW,
+        medium       = MEMORY_PRIORITY_MEDIUM,
+        below_normal = MEMORY_PRIORITY_BELOW_NORMAL,
+        normal       = MEMORY_PRIORITY_NORMAL
+    };
+
+    /// \brief Brings the pages of all ranges into memory with a single
+    ///        VmPrefetchInformation request. The reads are issued in large batches
+    ///        instead of one page fault at a time.
+    /// \note The pages are not added to the working set so nothing is charged against
+    ///       it, but they are likely to be soft faulted in once accessed.
+    template<class Process = void*>
+    NTW_INLINE status prefetch(std::span<const range> ranges,
+                               const Process& process = NtCurrentProcess()) noexcept;
+
+    /// \brief Sets the priority of the pages in all ranges with a single
+    ///        VmPagePriorityInformation request.
+    template<class Process = void*>
+    NTW_INLINE status
+    set_page_priority(std::span<const range> ranges,
+                      page_priority          priority,
+                      const Process&         process = NtCurrentProcess()) noexcept;
+
+} // namespace ntw::vm
+
+#include "impl/hints.inl"
@@ -22,51 +22,46 @@
 namespace ntw::vm {
 
     template<class Process>
-    NTW_INLINE result<void*> allocation_builder::commit(
-        std::size_t size, protection prot, const Process& process) const noexcept
+    NTW_INLINE result<void*>
+    allocation_builder::_allocate(std::size_t    size,
+                                  std::uint32_t  type,
+                                  protection     prot,
+                                  const Process& process) const noexcept
     {
         void*    addr     = _address;
         SIZE_T   win_size = size;
-        NTSTATUS result =
-            NTW_SYSCALL(NtAllocateVirtualMemory)(::ntw::detail::unwrap(process),
-                                                 &addr,
-                                                 _zero,
-                                                 &win_size,
-                                                 _type | MEM_COMMIT,
-                                                 prot.get());
+        const auto handle   = ::ntw::detail::unwrap(process);
+
+        // placeholders are only understood by the extended version
+        NTSTATUS result;
+        if(type & (MEM_RESERVE_PLACEHOLDER | MEM_REPLACE_PLACEHOLDER))
+            result = NTW_SYSCALL(NtAllocateVirtualMemoryEx)(
+                handle, &addr, &win_size, type, prot.get(), nullptr, 0);
+        else
+            result = NTW_SYSCALL(NtAllocateVirtualMemory)(
+                handle, &addr, _zero, &win_size, type, prot.get());
         return { result, addr };
     }
 
+    template<class Process>
+    NTW_INLINE result<void*> allocation_builder::commit(
+        std::size_t size, protection prot, const Process& process) const noexcept
+    {
+        return _allocate(size, _type | MEM_COMMIT, prot, process);
+    }
+
     template<class Process>
     NTW_INLINE result<void*> allocation_builder::reserve(
         std::size_t size, protection prot, const Process& process) const noexcept
     {
-        void*    addr     = _address;
-        SIZE_T   win_size = size;
-        NTSTATUS result =
-            NTW_SYSCALL(NtAllocateVirtualMemory)(::ntw::detail::unwrap(process),
-                                                 &addr,
-                                                 _zero,
-                                                 &win_size,
-                                                 _type | MEM_RESERVE,
-                                                 prot.get());
-        return { result, addr };
+        return _allocate(size, _type | MEM_RESERVE, prot, process);
     }
 
     template<class Process>
     NTW_INLINE result<void*> allocation_builder::commit_reserve(
         std::size_t size, protection prot, const Process& process) const noexcept
     {
-        void*    addr     = _address;
-        SIZE_T   win_size = size;
-        NTSTATUS result =
-            NTW_SYSCALL(NtAllocateVirtualMemory)(::ntw::detail::unwrap(process),
-                                                 &addr,
-                                                 _zero,
-                                                 &win_size,
-                                                 _type | MEM_COMMIT | MEM_RESERVE,
-                                                 prot.get());
-        return { result, addr };
+        return _allocate(size, _type | MEM_COMMIT | MEM_RESERVE, prot, process);
     }
 
     NTW_INLINE constexpr allocation_builder& allocation_builder::zero_bits(
@@ -114,6 +109,20 @@ namespace ntw::vm {
         return *this;
     }
 
+    NTW_INLINE constexpr allocation_builder&
+    allocation_builder::replace_placeholder() noexcept
+    {
+        _type |= MEM_REPLACE_PLACEHOLDER;
+        return *this;
+    }
+
+    NTW_INLINE constexpr allocation_builder&
+    allocation_builder::reserve_placeholder() noexcept
+    {
+        _type |= MEM_RESERVE_PLACEHOLDER;
+        return *this;
+    }
+
     NTW_INLINE constexpr allocation_builder allocate() noexcept { return {}; }
 
 } // namespace ntw::vm
\ No newline at end of file
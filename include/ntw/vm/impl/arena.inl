@@ -0,0 +1,221 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../arena.hpp"
+
+namespace ntw::vm {
+
+    NTW_INLINE arena::chunk* arena::_chunk_list() const noexcept
+    {
+        return _chunks.as<chunk>();
+    }
+
+    NTW_INLINE std::size_t arena::_align(std::size_t offset,
+                                         std::size_t alignment) const noexcept
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(_base) + offset;
+        return offset + ((alignment - (address & (alignment - 1))) & (alignment - 1));
+    }
+
+    NTW_INLINE status arena::_commit(std::size_t begin, std::size_t size) noexcept
+    {
+        return vm::allocate()
+            .at(_base + begin)
+            .commit(size, protection::read_write())
+            .status();
+    }
+
+    NTW_INLINE status arena::_grow(std::size_t size, std::size_t alignment) noexcept
+    {
+        const auto aligned = _align(_offset, alignment);
+        if(aligned > _reserved || size > _reserved - aligned)
+            return STATUS_NO_MEMORY;
+
+        const auto target = std::max(aligned + size, _limit + _chunk_size);
+        const auto limit =
+            std::min((target + page_size - 1) & ~(page_size - 1), _reserved);
+        if(const auto s = _commit(_limit, limit - _limit); !s.success())
+            return s;
+
+        _limit = _high = limit;
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE status arena::_grow_guarded(std::size_t size,
+                                           std::size_t alignment) noexcept
+    {
+        // chunks begin on a page boundary so only larger alignments need extra space
+        const auto needed = size + (alignment > page_size ? alignment - page_size : 0);
+
+        // chunks left committed by a previous pass are reused if they are large enough
+        if(_chunk < _chunk_count && _chunk_list()[_chunk].size >= needed) {
+            const auto c = _chunk_list()[_chunk++];
+            _offset      = c.begin;
+            _limit       = c.begin + c.size;
+            return STATUS_SUCCESS;
+        }
+
+        const auto begin = _chunk ? _limit + page_size : 0;
+        const auto usable =
+            (std::max(needed, _chunk_size) + page_size - 1) & ~(page_size - 1);
+        if(needed > _reserved || usable + page_size > _reserved - begin)
+            return STATUS_NO_MEMORY;
+
+        if(const auto s = _chunks.reserve((_chunk + 1) * sizeof(chunk), true);
+           !s.success())
+            return s;
+
+        // the layout of the rest of the previous pass no longer matches
+        if(_high > begin) {
+            if(const auto s = vm::decommit(_base + begin, _high - begin); !s.success())
+                return s;
+            _high = begin;
+        }
+
+        if(const auto s = _commit(begin, usable); !s.success())
+            return s;
+
+        _chunk_list()[_chunk++] = { begin, usable };
+        _chunk_count            = _chunk;
+        _offset                 = begin;
+        _limit                  = begin + usable;
+        _high                   = _limit;
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE arena::~arena() noexcept
+    {
+        if(_base)
+            static_cast<void>(vm::release(_base));
+    }
+
+    NTW_INLINE arena::arena(arena&& other) noexcept { *this = std::move(other); }
+
+    NTW_INLINE arena& arena::operator=(arena&& other) noexcept
+    {
+        std::swap(_base, other._base);
+        std::swap(_reserved, other._reserved);
+        std::swap(_offset, other._offset);
+        std::swap(_limit, other._limit);
+        std::swap(_high, other._high);
+        std::swap(_chunk_size, other._chunk_size);
+        std::swap(_guard, other._guard);
+        std::swap(_chunks, other._chunks);
+        std::swap(_chunk_count, other._chunk_count);
+        std::swap(_chunk, other._chunk);
+        return *this;
+    }
+
+    NTW_INLINE arena& arena::chunk_size(std::size_t size) noexcept
+    {
+        _chunk_size = (std::max(size, page_size) + page_size - 1) & ~(page_size - 1);
+        return *this;
+    }
+
+    NTW_INLINE arena& arena::guard_pages() noexcept
+    {
+        _guard = true;
+        return *this;
+    }
+
+    NTW_INLINE status arena::reserve(std::size_t size) noexcept
+    {
+        if(_base)
+            static_cast<void>(vm::release(_base));
+
+        _base        = nullptr;
+        _reserved    = 0;
+        _chunk_count = 0;
+        rewind();
+        _high = 0;
+
+        size           = (size + page_size - 1) & ~(page_size - 1);
+        const auto res = vm::allocate().reserve(size, protection::read_write());
+        if(!res)
+            return res.status();
+
+        _base     = static_cast<std::uint8_t*>(*res);
+        _reserved = size;
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE result<void*> arena::allocate(std::size_t size,
+                                             std::size_t alignment) noexcept
+    {
+        auto aligned = _align(_offset, alignment);
+        if(aligned > _limit || size > _limit - aligned) {
+            const auto s =
+                _guard ? _grow_guarded(size, alignment) : _grow(size, alignment);
+            if(!s.success())
+                return s;
+
+            aligned = _align(_offset, alignment);
+        }
+
+        _offset = aligned + size;
+        return { STATUS_SUCCESS, _base + aligned };
+    }
+
+    NTW_INLINE void arena::rewind() noexcept
+    {
+        _offset = 0;
+        _chunk  = 0;
+        _limit  = _guard ? 0 : _high;
+    }
+
+    NTW_INLINE status arena::reset() noexcept
+    {
+        rewind();
+        if(!_high)
+            return STATUS_SUCCESS;
+        if(!_guard)
+            return vm::reset(_base, _high);
+
+        // guard pages are not committed so chunks are reset one by one
+        for(std::size_t i = 0; i < _chunk_count; ++i) {
+            const auto c = _chunk_list()[i];
+            if(const auto s = vm::reset(_base + c.begin, c.size); !s.success())
+                return s;
+        }
+
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE status arena::decommit() noexcept
+    {
+        rewind();
+        if(!_high)
+            return STATUS_SUCCESS;
+
+        if(const auto s = vm::decommit(_base, _high); !s.success())
+            return s;
+
+        _high        = 0;
+        _limit       = 0;
+        _chunk_count = 0;
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE std::size_t arena::used() const noexcept { return _offset; }
+
+    NTW_INLINE std::size_t arena::committed() const noexcept { return _high; }
+
+    NTW_INLINE std::size_t arena::reserved() const noexcept { return _reserved; }
+
+    NTW_INLINE void* arena::data() const noexcept { return _base; }
+
+} // namespace ntw::vm
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../batch_read.hpp"
+
+namespace ntw::vm {
+
+    NTW_INLINE status batch_reader::_read_run(void*                   process,
+                                              std::span<read_request> requests,
+                                              const std::uint32_t*    first,
+                                              const std::uint32_t*    last,
+                                              std::uintptr_t          begin,
+                                              std::uintptr_t          end) noexcept
+    {
+        const auto size = end - begin;
+        if(const auto s = _staging.reserve(size); !s.success())
+            return s;
+        if(const auto s = _pages.reserve(size / page_size * sizeof(ntw::status));
+           !s.success())
+            return s;
+
+        const auto staging = _staging.data();
+        const auto pages   = _pages.as<ntw::status>();
+
+        std::size_t offset = 0;
+        while(offset < size) {
+            SIZE_T            read = 0;
+            const ntw::status s    = NTW_SYSCALL(NtReadVirtualMemory)(
+                process,
+                reinterpret_cast<void*>(begin + offset),
+                staging + offset,
+                size - offset,
+                &read);
+
+            // the amount read may be reported with a coarser granularity than pages,
+            // so the first page that was not fully read is retried on its own
+            const auto done = offset + (s.success() ? size - offset : read);
+            const auto good = done & ~(page_size - 1);
+            for(; offset < good; offset += page_size)
+                pages[offset / page_size] = STATUS_SUCCESS;
+
+            if(offset >= size)
+                break;
+
+            pages[offset / page_size] =
+                NTW_SYSCALL(NtReadVirtualMemory)(process,
+                                                 reinterpret_cast<void*>(begin + offset),
+                                                 staging + offset,
+                                                 page_size,
+                                                 nullptr);
+            offset += page_size;
+        }
+
+        for(; first != last; ++first) {
+            auto&      request   = requests[*first];
+            const auto offset    = request.address - begin;
+            const auto last_page = (offset + request.size - 1) / page_size;
+
+            request.status = STATUS_SUCCESS;
+            for(auto page = offset / page_size; page <= last_page; ++page) {
+                if(!pages[page].success()) {
+                    request.status = pages[page];
+                    break;
+                }
+            }
+
+            if(request.status.success())
+                std::memcpy(request.buffer, staging + offset, request.size);
+        }
+
+        return STATUS_SUCCESS;
+    }
+
+    template<class Process>
+    NTW_INLINE status batch_reader::read(std::span<read_request> requests,
+                                         const Process&          process) noexcept
+    {
+        const auto handle = ::ntw::detail::unwrap(process);
+
+        if(const auto s = _order.reserve(requests.size() * sizeof(std::uint32_t));
+           !s.success()) {
+            for(auto& request : requests)
+                request.status = s;
+            return s;
+        }
+
+        const auto  order = _order.as<std::uint32_t>();
+        std::size_t count = 0;
+        for(std::uint32_t i = 0; i < requests.size(); ++i) {
+            auto& request = requests[i];
+            if(!request.size)
+                request.status = STATUS_SUCCESS;
+            // the last page of request must not wrap around when aligned up
+            else if(request.address > ~std::uintptr_t{ 0 } - page_size ||
+                    request.size > ~std::uintptr_t{ 0 } - page_size - request.address)
+                request.status = STATUS_INVALID_PARAMETER;
+            // large reads would only be copied twice through the staging buffer
+            else if(request.size >= direct_read_size)
+                request.status = NTW_SYSCALL(NtReadVirtualMemory)(
+                    handle,
+                    reinterpret_cast<void*>(request.address),
+                    request.buffer,
+                    request.size,
+                    nullptr);
+            else
+                order[count++] = i;
+        }
+
+        std::sort(order, order + count, [requests](std::uint32_t lhs, std::uint32_t rhs) {
+            return requests[lhs].address < requests[rhs].address;
+        });
+
+        const auto page_begin = [requests](std::uint32_t i) {
+            return requests[i].address & ~(page_size - 1);
+        };
+        const auto page_end = [requests](std::uint32_t i) {
+            const auto& r = requests[i];
+            return (r.address + r.size + page_size - 1) & ~(page_size - 1);
+        };
+
+        // requests whose pages overlap or touch are read together
+        for(std::size_t i = 0; i < count;) {
+            const auto begin = page_begin(order[i]);
+            auto       end   = page_end(order[i]);
+            auto       j     = i + 1;
+            for(; j < count && page_begin(order[j]) <= end; ++j)
+                end = std::max(end, page_end(order[j]));
+
+            const auto s = _read_run(handle, requests, order + i, order + j, begin, end);
+            if(!s.success()) {
+                for(; i < count; ++i)
+                    requests[order[i]].status = s;
+                return s;
+            }
+
+            i = j;
+        }
+
+        for(const auto& request : requests)
+            if(!request.status.success())
+                return STATUS_PARTIAL_COPY;
+
+        return STATUS_SUCCESS;
+    }
+
+} // namespace ntw::vm
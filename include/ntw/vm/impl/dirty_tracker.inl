@@ -0,0 +1,103 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../dirty_tracker.hpp"
+#include <cstring>
+
+namespace ntw::vm {
+
+    template<class Process>
+    NTW_INLINE result<std::size_t> dirty_tracker::_query(bool           reset,
+                                                         const Process& process) noexcept
+    {
+        // every page of the region fits so the list is never truncated
+        const auto count = page_count();
+        if(const auto s = _pages.reserve(count * sizeof(void*)); !s.success())
+            return s;
+
+        ULONG_PTR  entries = count;
+        ULONG      granularity;
+        const auto s =
+            NTW_SYSCALL(NtGetWriteWatch)(::ntw::detail::unwrap(process),
+                                         reset ? WRITE_WATCH_FLAG_RESET : 0,
+                                         _base,
+                                         _size,
+                                         reinterpret_cast<void**>(_pages.data()),
+                                         &entries,
+                                         &granularity);
+        return { s, static_cast<std::size_t>(entries) };
+    }
+
+    template<class Address>
+    NTW_INLINE dirty_tracker::dirty_tracker(Address address, std::size_t size) noexcept
+        : _base(static_cast<std::uint8_t*>(
+              const_cast<void*>(reinterpret_cast<const void*>(address))))
+        , _size(size)
+    {}
+
+    template<class Process>
+    NTW_INLINE result<std::span<void* const>>
+               dirty_tracker::dirty_pages(bool reset, const Process& process) noexcept
+    {
+        const auto entries = _query(reset, process);
+        if(!entries)
+            return entries.status();
+
+        return { STATUS_SUCCESS, { _pages.as<void*>(), *entries } };
+    }
+
+    template<class Process>
+    NTW_INLINE result<std::span<const std::uint64_t>>
+               dirty_tracker::dirty_bitmap(bool reset, const Process& process) noexcept
+    {
+        const auto words = (page_count() + 63) / 64;
+        if(const auto s = _bitmap.reserve(words * sizeof(std::uint64_t)); !s.success())
+            return s;
+
+        const auto entries = _query(reset, process);
+        if(!entries)
+            return entries.status();
+
+        const auto bitmap = _bitmap.as<std::uint64_t>();
+        std::memset(bitmap, 0, words * sizeof(std::uint64_t));
+
+        const auto pages = _pages.as<std::uint8_t*>();
+        for(std::size_t i = 0; i < *entries; ++i) {
+            const auto page = static_cast<std::size_t>(pages[i] - _base) / page_size;
+            bitmap[page / 64] |= std::uint64_t{ 1 } << (page % 64);
+        }
+
+        return { STATUS_SUCCESS, { bitmap, words } };
+    }
+
+    template<class Process>
+    NTW_INLINE status dirty_tracker::reset(const Process& process) noexcept
+    {
+        return NTW_SYSCALL(NtResetWriteWatch)(
+            ::ntw::detail::unwrap(process), _base, _size);
+    }
+
+    NTW_INLINE std::size_t dirty_tracker::page_count() const noexcept
+    {
+        return (_size + page_size - 1) / page_size;
+    }
+
+    NTW_INLINE void* dirty_tracker::data() const noexcept { return _base; }
+
+    NTW_INLINE std::size_t dirty_tracker::size() const noexcept { return _size; }
+
+} // namespace ntw::vm
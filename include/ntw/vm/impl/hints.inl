@@ -0,0 +1,67 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../hints.hpp"
+#include "../../detail/unwrap.hpp"
+
+namespace ntw::detail {
+
+    NTW_INLINE ntw::status
+    set_virtual_memory_info(void*                            process,
+                            VIRTUAL_MEMORY_INFORMATION_CLASS info_class,
+                            std::span<const vm::range>       ranges,
+                            unsigned long                    info) noexcept
+    {
+        if(ranges.empty())
+            return STATUS_SUCCESS;
+
+        // range is layout compatible with MEMORY_RANGE_ENTRY
+        return NTW_SYSCALL(NtSetInformationVirtualMemory)(
+            process,
+            info_class,
+            static_cast<ULONG_PTR>(ranges.size()),
+            reinterpret_cast<PMEMORY_RANGE_ENTRY>(const_cast<vm::range*>(ranges.data())),
+            &info,
+            sizeof(info));
+    }
+
+} // namespace ntw::detail
+
+namespace ntw::vm {
+
+    template<class Process>
+    NTW_INLINE status prefetch(std::span<const range> ranges,
+                               const Process&         process) noexcept
+    {
+        // the flags must be 0
+        return ::ntw::detail::set_virtual_memory_info(
+            ::ntw::detail::unwrap(process), VmPrefetchInformation, ranges, 0);
+    }
+
+    template<class Process>
+    NTW_INLINE status set_page_priority(std::span<const range> ranges,
+                                        page_priority          priority,
+                                        const Process&         process) noexcept
+    {
+        return ::ntw::detail::set_virtual_memory_info(
+            ::ntw::detail::unwrap(process),
+            VmPagePriorityInformation,
+            ranges,
+            static_cast<unsigned long>(priority));
+    }
+
+} // namespace ntw::vm
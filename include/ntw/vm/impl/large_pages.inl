@@ -0,0 +1,69 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../large_pages.hpp"
+#include <algorithm>
+
+namespace ntw::vm {
+
+    NTW_INLINE std::size_t large_page_minimum() noexcept
+    {
+        return USER_SHARED_DATA->LargePageMinimum;
+    }
+
+    template<class Process>
+    NTW_INLINE result<large_page_allocation>
+               large_page_alloc(std::size_t size, const Process& process) noexcept
+    {
+        constexpr std::size_t page_size = 0x1000;
+
+        const auto minimum = large_page_minimum();
+        if(size > ~std::size_t{ 0 } - std::max(minimum, page_size))
+            return { STATUS_INVALID_PARAMETER };
+
+        large_page_allocation allocation;
+        if(!minimum)
+            allocation.fallback_reason = STATUS_NOT_SUPPORTED;
+        else
+            allocation.fallback_reason =
+                ob::enable_privilege_once(ob::privilege::lock_memory());
+
+        if(allocation.fallback_reason.success()) {
+            // large pages have to be reserved and committed at once
+            allocation.size = (size + minimum - 1) & ~(minimum - 1);
+            const auto res  = allocate().large_pages().commit_reserve(
+                allocation.size, protection::read_write(), process);
+            if(res) {
+                allocation.address = *res;
+                return { STATUS_SUCCESS, allocation };
+            }
+
+            // usually there is not enough contiguous physical memory
+            allocation.fallback_reason = res.status();
+        }
+
+        allocation.size = (size + page_size - 1) & ~(page_size - 1);
+        const auto res  = allocate().commit_reserve(
+            allocation.size, protection::read_write(), process);
+        if(!res)
+            return res.status();
+
+        allocation.address = *res;
+        return { STATUS_SUCCESS, allocation };
+    }
+
+} // namespace ntw::vm
@@ -64,11 +64,25 @@ namespace ntw::vm {
             ::ntw::detail::unwrap(process), &casted, &win_size, MEM_DECOMMIT);
     }
 
+    template<class Address, class Process>
+    NTW_INLINE status split_placeholder(Address        addr,
+                                        std::size_t    size,
+                                        const Process& process) noexcept
+    {
+        auto   casted   = const_cast<void*>(reinterpret_cast<const void*>(addr));
+        SIZE_T win_size = size;
+
+        return NTW_SYSCALL(NtFreeVirtualMemory)(::ntw::detail::unwrap(process),
+                                                &casted,
+                                                &win_size,
+                                                MEM_RELEASE | MEM_PRESERVE_PLACEHOLDER);
+    }
+
     template<class Address, class Process>
     NTW_INLINE status unmap(Address addr, const Process& process) noexcept
     {
         auto casted = const_cast<void*>(reinterpret_cast<const void*>(addr));
-        return NTW_SYSCALL(NtUnmapViewOfSection)(::ntw::detail::unwrap(process), &casted);
+        return NTW_SYSCALL(NtUnmapViewOfSection)(::ntw::detail::unwrap(process), casted);
     }
 
 } // namespace ntw::vm
\ No newline at end of file
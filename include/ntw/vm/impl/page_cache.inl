@@ -0,0 +1,261 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../page_cache.hpp"
+
+namespace ntw::vm {
+
+    NTW_INLINE constexpr std::size_t page_cache::_hash(std::uintptr_t page) noexcept
+    {
+        return static_cast<std::size_t>(
+            (static_cast<std::uint64_t>(page / page_size) * 0x9E3779B97F4A7C15ull) >> 32);
+    }
+
+    NTW_INLINE page_cache::entry* page_cache::_entry(std::uint32_t idx) const noexcept
+    {
+        return _entries.as<entry>() + idx;
+    }
+
+    NTW_INLINE void page_cache::_unlink(std::uint32_t idx) const noexcept
+    {
+        const auto e          = _entry(idx);
+        _entry(e->prev)->next = e->next;
+        _entry(e->next)->prev = e->prev;
+    }
+
+    NTW_INLINE void page_cache::_link_front(std::uint32_t idx) const noexcept
+    {
+        const auto head       = _entry(0);
+        const auto e          = _entry(idx);
+        e->prev               = 0;
+        e->next               = head->next;
+        _entry(e->next)->prev = idx;
+        head->next            = idx;
+    }
+
+    NTW_INLINE void page_cache::_link_back(std::uint32_t idx) const noexcept
+    {
+        const auto head       = _entry(0);
+        const auto e          = _entry(idx);
+        e->next               = 0;
+        e->prev               = head->prev;
+        _entry(e->prev)->next = idx;
+        head->prev            = idx;
+    }
+
+    NTW_INLINE std::uint32_t page_cache::_find(std::uintptr_t page) const noexcept
+    {
+        const auto table = _table.as<std::uint32_t>();
+        for(auto i = _hash(page) & _mask; table[i]; i = (i + 1) & _mask)
+            if(_entry(table[i])->page == page)
+                return table[i];
+        return 0;
+    }
+
+    NTW_INLINE void page_cache::_insert(std::uint32_t idx) const noexcept
+    {
+        const auto table = _table.as<std::uint32_t>();
+
+        auto i = _hash(_entry(idx)->page) & _mask;
+        while(table[i])
+            i = (i + 1) & _mask;
+
+        table[i] = idx;
+    }
+
+    NTW_INLINE void page_cache::_erase(std::uint32_t idx) const noexcept
+    {
+        const auto table = _table.as<std::uint32_t>();
+
+        auto i = _hash(_entry(idx)->page) & _mask;
+        while(table[i] != idx)
+            i = (i + 1) & _mask;
+
+        // shifts back the following entries of the cluster so that no tombstones are
+        // needed. An entry can fill the hole if its home slot is not between the hole
+        // and its current slot.
+        for(auto j = (i + 1) & _mask; table[j]; j = (j + 1) & _mask) {
+            const auto home = _hash(_entry(table[j])->page) & _mask;
+            if(((j - home) & _mask) >= ((j - i) & _mask)) {
+                table[i] = table[j];
+                i        = j;
+            }
+        }
+
+        table[i] = 0;
+    }
+
+    NTW_INLINE ntw::result<const std::uint8_t*>
+               page_cache::_page(std::uintptr_t page) noexcept
+    {
+        auto idx = _find(page);
+        auto e   = _entry(idx);
+        if(idx && e->generation == _generation) {
+            _unlink(idx);
+            _link_front(idx);
+            return { STATUS_SUCCESS, _arena.data() + (idx - 1) * page_size };
+        }
+
+        // stale pages are read again into the same entry, otherwise the least
+        // recently used entry is taken over
+        if(!idx) {
+            idx = _entry(0)->prev;
+            e   = _entry(idx);
+            if(e->page != _no_page)
+                _erase(idx);
+
+            e->page = page;
+            _insert(idx);
+        }
+
+        const auto        data = _arena.data() + (idx - 1) * page_size;
+        const ntw::status s    = NTW_SYSCALL(NtReadVirtualMemory)(
+            _process, reinterpret_cast<void*>(page), data, page_size, nullptr);
+
+        _unlink(idx);
+        if(!s.success()) {
+            _erase(idx);
+            e->page = _no_page;
+            _link_back(idx);
+            return s;
+        }
+
+        e->generation = _generation;
+        _link_front(idx);
+        return { s, data };
+    }
+
+    template<class Process>
+    NTW_INLINE page_cache::page_cache(const Process& process) noexcept
+        : _process(::ntw::detail::unwrap(process))
+    {}
+
+    NTW_INLINE status page_cache::reserve(std::size_t pages) noexcept
+    {
+        _capacity = 0;
+        _mask     = 0;
+
+        std::size_t table_size = 2;
+        while(table_size < pages * 2)
+            table_size *= 2;
+
+        ntw::detail::growable_buffer arena, entries, table;
+        if(const auto s = arena.reserve(pages * page_size); !s.success())
+            return s;
+        if(const auto s = entries.reserve((pages + 1) * sizeof(entry)); !s.success())
+            return s;
+        if(const auto s = table.reserve(table_size * sizeof(std::uint32_t)); !s.success())
+            return s;
+
+        std::memset(table.data(), 0, table_size * sizeof(std::uint32_t));
+
+        // every entry starts out in the list without a page
+        const auto count = static_cast<std::uint32_t>(pages + 1);
+        for(std::uint32_t i = 0; i < count; ++i)
+            entries.as<entry>()[i] = {
+                _no_page, 0, (i + count - 1) % count, (i + 1) % count
+            };
+
+        _arena    = std::move(arena);
+        _entries  = std::move(entries);
+        _table    = std::move(table);
+        _capacity = pages;
+        _mask     = table_size - 1;
+        return STATUS_SUCCESS;
+    }
+
+    template<class Address>
+    NTW_INLINE status page_cache::read_mem(Address     addr,
+                                           void*       buffer,
+                                           std::size_t size) noexcept
+    {
+        if(!_capacity)
+            return NTW_SYSCALL(NtReadVirtualMemory)(
+                _process,
+                const_cast<void*>(reinterpret_cast<const void*>(addr)),
+                buffer,
+                size,
+                nullptr);
+
+        auto address =
+            reinterpret_cast<std::uintptr_t>(reinterpret_cast<const void*>(addr));
+        auto out = static_cast<std::uint8_t*>(buffer);
+        while(size) {
+            const auto offset = address & (page_size - 1);
+            const auto count  = std::min(size, page_size - offset);
+
+            const auto data = _page(address - offset);
+            if(!data)
+                return data.status();
+
+            std::memcpy(out, *data + offset, count);
+            out += count;
+            address += count;
+            size -= count;
+        }
+
+        return STATUS_SUCCESS;
+    }
+
+    template<class Address, class Range>
+    NTW_INLINE status page_cache::read_mem(Address addr, Range&& range) noexcept
+    {
+        return read_mem(
+            addr,
+            static_cast<void*>(::ntw::detail::unfancy(::ntw::detail::adl_begin(range))),
+            ::ntw::detail::range_byte_size(range));
+    }
+
+    NTW_INLINE void page_cache::invalidate() noexcept { ++_generation; }
+
+    template<class Address>
+    NTW_INLINE void page_cache::invalidate(Address addr, std::size_t size) noexcept
+    {
+        if(!_capacity || !size)
+            return;
+
+        const auto address =
+            reinterpret_cast<std::uintptr_t>(reinterpret_cast<const void*>(addr));
+        const auto first = address & ~(page_size - 1);
+        const auto last  = (address + size - 1) & ~(page_size - 1);
+
+        // ranges larger than the cache are cheaper to match against every entry
+        if((last - first) / page_size >= _capacity) {
+            for(std::uint32_t idx = 1; idx <= _capacity; ++idx) {
+                const auto e = _entry(idx);
+                if(e->page != _no_page && e->page >= first && e->page <= last)
+                    e->generation = 0;
+            }
+            return;
+        }
+
+        for(auto page = first;; page += page_size) {
+            if(const auto idx = _find(page))
+                _entry(idx)->generation = 0;
+            if(page == last)
+                break;
+        }
+    }
+
+    NTW_INLINE std::uint64_t page_cache::generation() const noexcept
+    {
+        return _generation;
+    }
+
+    NTW_INLINE std::size_t page_cache::capacity() const noexcept { return _capacity; }
+
+} // namespace ntw::vm
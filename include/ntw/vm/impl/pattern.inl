@@ -0,0 +1,166 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../pattern.hpp"
+
+namespace ntw::detail {
+
+    /// \brief Returns the value of a hex digit or -1 for other characters.
+    NTW_INLINE constexpr int hex_digit(char c) noexcept
+    {
+        if(c >= '0' && c <= '9')
+            return c - '0';
+        if(c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if(c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+
+} // namespace ntw::detail
+
+namespace ntw::vm {
+
+    NTW_INLINE status pattern::_push(std::uint8_t byte, std::uint8_t mask) noexcept
+    {
+        if(_size == max_size)
+            return STATUS_INVALID_PARAMETER;
+
+        if(mask == 0xFF) {
+            if(!_anchored)
+                _first = _size;
+            _last     = _size;
+            _anchored = true;
+        }
+
+        _bytes[_size] = byte & mask;
+        _masks[_size] = mask;
+        ++_size;
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE result<pattern> pattern::parse(std::string_view ida) noexcept
+    {
+        pattern p;
+        for(std::size_t i = 0; i < ida.size();) {
+            if(ida[i] == ' ') {
+                ++i;
+                continue;
+            }
+
+            auto end = ida.find(' ', i);
+            if(end == std::string_view::npos)
+                end = ida.size();
+
+            const auto token = ida.substr(i, end - i);
+            i                = end;
+
+            std::uint8_t byte = 0, mask = 0;
+            if(token == "?" || token == "??") {
+                // matches any byte
+            }
+            else if(token.size() == 2) {
+                for(const auto c : token) {
+                    byte <<= 4;
+                    mask <<= 4;
+                    if(c == '?')
+                        continue;
+
+                    const auto digit = ::ntw::detail::hex_digit(c);
+                    if(digit < 0)
+                        return { STATUS_INVALID_PARAMETER };
+
+                    byte |= static_cast<std::uint8_t>(digit);
+                    mask |= 0xF;
+                }
+            }
+            else
+                return { STATUS_INVALID_PARAMETER };
+
+            if(const auto s = p._push(byte, mask); !s.success())
+                return s;
+        }
+
+        if(!p._size)
+            return { STATUS_INVALID_PARAMETER };
+
+        return { STATUS_SUCCESS, p };
+    }
+
+    NTW_INLINE result<pattern> pattern::from_mask(std::span<const std::uint8_t> bytes,
+                                                  std::string_view mask) noexcept
+    {
+        if(bytes.empty() || bytes.size() != mask.size())
+            return { STATUS_INVALID_PARAMETER };
+
+        pattern p;
+        for(std::size_t i = 0; i < bytes.size(); ++i) {
+            if(mask[i] != 'x' && mask[i] != '?')
+                return { STATUS_INVALID_PARAMETER };
+
+            if(const auto s = p._push(bytes[i], mask[i] == 'x' ? 0xFF : 0); !s.success())
+                return s;
+        }
+
+        return { STATUS_SUCCESS, p };
+    }
+
+    NTW_INLINE std::size_t pattern::size() const noexcept { return _size; }
+
+    NTW_INLINE bool pattern::matches(const std::uint8_t* data) const noexcept
+    {
+        for(std::size_t i = 0; i < _size; ++i)
+            if((data[i] & _masks[i]) != _bytes[i])
+                return false;
+        return true;
+    }
+
+    NTW_INLINE std::size_t pattern::find(std::span<const std::uint8_t> data,
+                                         std::size_t from) const noexcept
+    {
+        if(!_size || data.size() < _size || from > data.size() - _size)
+            return npos;
+
+        // match can start at any offset below end
+        const auto end   = data.size() - _size + 1;
+        const auto first = data.data();
+
+        auto i = from;
+        if(_anchored) {
+            // candidates have both the first and the last exact bytes in place, which
+            // rejects nearly every offset before the whole pattern is compared
+            const auto a = _bytes[_first];
+            const auto b = _bytes[_last];
+            for(; i + 16 <= end; i += 16) {
+                auto candidates = ::ntw::detail::simd::equal_pair16(
+                    first + i + _first, a, first + i + _last, b);
+                for(; candidates; candidates &= candidates - 1) {
+                    const auto offset = i + std::countr_zero(candidates);
+                    if(matches(first + offset))
+                        return offset;
+                }
+            }
+        }
+
+        for(; i < end; ++i)
+            if(matches(first + i))
+                return i;
+
+        return npos;
+    }
+
+} // namespace ntw::vm
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../pattern_scan.hpp"
+
+namespace ntw::vm {
+
+    template<class Context>
+    NTW_INLINE NTSTATUS NTAPI pattern_scanner::_worker(void* argument) noexcept
+    {
+        auto& ctx = *static_cast<Context*>(argument);
+
+        // a worker without a buffer takes no chunks so the others scan them instead
+        ntw::detail::growable_buffer buffer;
+        if(const auto s = buffer.reserve(ctx.read_size); !s.success()) {
+            ctx.status.store(s.get(), std::memory_order_relaxed);
+            return s.get();
+        }
+
+        while(true) {
+            const auto i = ctx.next.fetch_add(1, std::memory_order_relaxed);
+            if(i >= ctx.count)
+                break;
+
+            const auto&       chunk = ctx.chunks[i];
+            const ntw::status s     = NTW_SYSCALL(NtReadVirtualMemory)(
+                ctx.process,
+                reinterpret_cast<void*>(chunk.address),
+                buffer.data(),
+                chunk.read_size,
+                nullptr);
+            if(!s.success())
+                continue;
+
+            const std::span<const std::uint8_t> data(buffer.data(), chunk.read_size);
+            for(std::size_t p = 0; p < ctx.patterns.size(); ++p) {
+                const auto& pattern = ctx.patterns[p];
+                // matches starting in the overlap belong to the next chunk
+                for(auto offset = pattern.find(data); offset < chunk.size;
+                    offset      = pattern.find(data, offset + 1))
+                    (*ctx.callback)(pattern_match{ chunk.address + offset, p });
+            }
+        }
+
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE pattern_scanner& pattern_scanner::workers(std::size_t count) noexcept
+    {
+        _workers = std::clamp(count, std::size_t{ 1 }, max_workers);
+        return *this;
+    }
+
+    NTW_INLINE pattern_scanner& pattern_scanner::chunk_size(std::size_t size) noexcept
+    {
+        _chunk_size = std::max(size, std::size_t{ 0x1000 });
+        return *this;
+    }
+
+    template<class Callback, class Process>
+    NTW_INLINE status
+    pattern_scanner::scan(std::span<const pattern> patterns,
+                          Callback                 callback,
+                          const Process&           process) const noexcept
+    {
+        using context_type = ::ntw::detail::scan_context<Callback>;
+        using chunk_type   = ::ntw::detail::scan_chunk;
+
+        if(patterns.empty())
+            return STATUS_SUCCESS;
+
+        std::size_t longest = 0;
+        for(const auto& p : patterns)
+            longest = std::max(longest, p.size());
+
+        const auto overlap = longest ? longest - 1 : 0;
+
+        ntw::detail::growable_buffer chunks;
+        std::size_t                  count     = 0;
+        std::size_t                  read_size = 0;
+
+        const auto add_span = [&](std::uintptr_t begin, std::uintptr_t end) {
+            for(auto address = begin; address < end; address += _chunk_size) {
+                if(const auto s = chunks.reserve((count + 1) * sizeof(chunk_type), true);
+                   !s.success())
+                    return s;
+
+                const auto size = std::min(_chunk_size, end - address);
+                const auto read = std::min(size + overlap, end - address);
+                chunks.as<chunk_type>()[count++] = { address, size, read };
+                read_size                        = std::max(read_size, read);
+            }
+            return ntw::status{ STATUS_SUCCESS };
+        };
+
+        // adjacent regions are scanned as one so matches can cross their borders
+        auto range = regions(process).where([](const memory::basic_info& info) {
+            return info.is_commited() && info.protect.readable() &&
+                   !info.protect.guarded();
+        });
+
+        std::uintptr_t begin = 0, end = 0;
+        for(const auto& info : range) {
+            if(info.base != end) {
+                if(const auto s = add_span(begin, end); !s.success())
+                    return s;
+                begin = info.base;
+            }
+            end = info.end();
+        }
+
+        if(!range.status().success())
+            return range.status();
+        if(const auto s = add_span(begin, end); !s.success())
+            return s;
+        if(!count)
+            return STATUS_SUCCESS;
+
+        context_type ctx{ ::ntw::detail::unwrap(process),
+                          patterns,
+                          &callback,
+                          chunks.as<chunk_type>(),
+                          count,
+                          read_size };
+
+        void*       threads[max_workers];
+        std::size_t thread_count = 0;
+        for(; thread_count + 1 < std::min(_workers, count); ++thread_count) {
+            const ntw::status s =
+                NTW_SYSCALL(NtCreateThreadEx)(&threads[thread_count],
+                                              SYNCHRONIZE,
+                                              nullptr,
+                                              NtCurrentProcess(),
+                                              &_worker<context_type>,
+                                              &ctx,
+                                              0,
+                                              0,
+                                              0,
+                                              0,
+                                              nullptr);
+            if(!s.success())
+                break;
+        }
+
+        _worker<context_type>(&ctx);
+
+        for(std::size_t i = 0; i < thread_count; ++i) {
+            NTW_SYSCALL(NtWaitForSingleObject)(threads[i], false, nullptr);
+            NTW_SYSCALL(NtClose)(threads[i]);
+        }
+
+        // chunks are left only if every worker failed to allocate its buffer
+        if(ctx.next.load() < count)
+            return ctx.status.load();
+
+        return STATUS_SUCCESS;
+    }
+
+} // namespace ntw::vm
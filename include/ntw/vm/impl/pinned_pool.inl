@@ -0,0 +1,175 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../pinned_pool.hpp"
+#include <limits>
+#include <new>
+
+namespace ntw::detail {
+
+    /// \brief Raises the minimum and maximum working set sizes of the current process.
+    NTW_INLINE ntw::status grow_working_set(std::size_t size) noexcept
+    {
+        const auto priv = ob::enable_privilege_once(ob::privilege::inc_working_set());
+        if(!priv.success())
+            return priv;
+
+        QUOTA_LIMITS current;
+        ntw::status  s = NTW_SYSCALL(NtQueryInformationProcess)(
+            NtCurrentProcess(), ProcessQuotaLimits, &current, sizeof(current), nullptr);
+        if(!s.success())
+            return s;
+
+        // the other limits are left zeroed as changing those needs more privileges
+        QUOTA_LIMITS limits{};
+        limits.MinimumWorkingSetSize = current.MinimumWorkingSetSize + size;
+        limits.MaximumWorkingSetSize = current.MaximumWorkingSetSize + size;
+        return NTW_SYSCALL(NtSetInformationProcess)(
+            NtCurrentProcess(), ProcessQuotaLimits, &limits, sizeof(limits));
+    }
+
+    /// \brief Locks the pages into the working set of the current process.
+    NTW_INLINE ntw::status lock_pages(void* address, std::size_t size) noexcept
+    {
+        const auto lock = [address, size]() -> ntw::status {
+            void*  lock_address = address;
+            SIZE_T lock_size    = size;
+            return NTW_SYSCALL(NtLockVirtualMemory)(
+                NtCurrentProcess(), &lock_address, &lock_size, MAP_PROCESS);
+        };
+
+        // the amount of locked pages is bounded by the working set minimum
+        const auto s = lock();
+        if(!(s == STATUS_WORKING_SET_QUOTA))
+            return s;
+
+        const auto grown = grow_working_set(size);
+        if(!grown.success())
+            return grown;
+
+        return lock();
+    }
+
+} // namespace ntw::detail
+
+namespace ntw::vm {
+
+    NTW_INLINE void pinned_pool::_destroy() noexcept
+    {
+        // locked pages are unlocked when released
+        if(_data)
+            static_cast<void>(vm::release(_data));
+
+        _head.store(0, std::memory_order_relaxed);
+        _data        = nullptr;
+        _next        = nullptr;
+        _buffer_size = 0;
+        _count       = 0;
+    }
+
+    NTW_INLINE pinned_pool::~pinned_pool() noexcept { _destroy(); }
+
+    NTW_INLINE status pinned_pool::create(std::size_t buffer_size,
+                                          std::size_t count) noexcept
+    {
+        _destroy();
+
+        constexpr auto max = std::numeric_limits<std::size_t>::max();
+        if(!buffer_size || !count || count >= std::numeric_limits<std::uint32_t>::max() ||
+           buffer_size > max - 63)
+            return STATUS_INVALID_PARAMETER;
+
+        // the links of the free list live after the buffers
+        buffer_size       = (buffer_size + 63) & ~std::size_t{ 63 };
+        const auto linked = buffer_size + sizeof(std::atomic<std::uint32_t>);
+        if(count > max / linked)
+            return STATUS_INVALID_PARAMETER;
+
+        const auto size = count * linked;
+        const auto res  = vm::allocate().commit_reserve(size);
+        if(!res)
+            return res.status();
+
+        const auto s = ::ntw::detail::lock_pages(*res, size);
+        if(!s.success()) {
+            static_cast<void>(vm::release(*res));
+            return s;
+        }
+
+        _data        = static_cast<std::uint8_t*>(*res);
+        _buffer_size = buffer_size;
+        _count       = count;
+
+        // initially every buffer links to the one after it
+        const auto links = _data + count * buffer_size;
+        _next            = reinterpret_cast<std::atomic<std::uint32_t>*>(links);
+        for(std::size_t i = 0; i < count; ++i)
+            ::new(_next + i) std::atomic<std::uint32_t>(
+                i + 1 < count ? static_cast<std::uint32_t>(i + 2) : 0);
+        _head.store(1, std::memory_order_release);
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE void* pinned_pool::acquire() noexcept
+    {
+        auto head = _head.load(std::memory_order_acquire);
+        for(;;) {
+            const auto index = static_cast<std::uint32_t>(head);
+            if(!index)
+                return nullptr;
+
+            // the link may be stale if another thread took the buffer meanwhile, but
+            // then the counter changed and the exchange fails
+            const auto next    = _next[index - 1].load(std::memory_order_relaxed);
+            const auto desired = (((head >> 32) + 1) << 32) | next;
+            if(_head.compare_exchange_weak(
+                   head, desired, std::memory_order_acquire, std::memory_order_acquire))
+                return _data + (index - 1) * _buffer_size;
+        }
+    }
+
+    NTW_INLINE void pinned_pool::release(void* buffer) noexcept
+    {
+        const auto index = static_cast<std::uint32_t>(
+            (static_cast<std::uint8_t*>(buffer) - _data) / _buffer_size);
+
+        auto          head = _head.load(std::memory_order_relaxed);
+        std::uint64_t desired;
+        do {
+            const auto first = static_cast<std::uint32_t>(head);
+            _next[index].store(first, std::memory_order_relaxed);
+            desired = (((head >> 32) + 1) << 32) | (index + 1);
+        } while(!_head.compare_exchange_weak(
+            head, desired, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    NTW_INLINE bool pinned_pool::contains(const void* address) const noexcept
+    {
+        const auto a = static_cast<const std::uint8_t*>(address);
+        return a >= _data && a < _data + _count * _buffer_size;
+    }
+
+    NTW_INLINE std::size_t pinned_pool::buffer_size() const noexcept
+    {
+        return _buffer_size;
+    }
+
+    NTW_INLINE std::size_t pinned_pool::count() const noexcept { return _count; }
+
+    NTW_INLINE void* pinned_pool::data() const noexcept { return _data; }
+
+} // namespace ntw::vm
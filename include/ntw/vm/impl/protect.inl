@@ -0,0 +1,190 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../protect.hpp"
+#include "../../detail/unwrap.hpp"
+#include <algorithm>
+
+namespace ntw::detail {
+
+    NTW_INLINE ntw::status protect_pages(void*          process,
+                                         std::uintptr_t begin,
+                                         std::size_t    size,
+                                         std::uint32_t  prot,
+                                         std::uint32_t& old) noexcept
+    {
+        void*  address  = reinterpret_cast<void*>(begin);
+        SIZE_T win_size = size;
+        ULONG  win_old  = 0;
+
+        const ntw::status s = NTW_SYSCALL(NtProtectVirtualMemory)(
+            process, &address, &win_size, prot, &win_old);
+        old = win_old;
+        return s;
+    }
+
+    /// \brief Checks that [begin, begin + size) lies within a single region, which is a
+    ///        run of pages sharing the same protection and state.
+    NTW_INLINE ntw::status single_region(void*          process,
+                                         std::uintptr_t begin,
+                                         std::size_t    size) noexcept
+    {
+        MEMORY_BASIC_INFORMATION info;
+        const ntw::status        s = NTW_SYSCALL(NtQueryVirtualMemory)(
+            process,
+            reinterpret_cast<void*>(begin),
+            MemoryBasicInformation,
+            &info,
+            sizeof(info),
+            nullptr);
+        if(!s.success())
+            return s;
+
+        const auto end = reinterpret_cast<std::uintptr_t>(info.BaseAddress) +
+                         info.RegionSize;
+        return begin + size <= end ? STATUS_SUCCESS : STATUS_CONFLICTING_ADDRESSES;
+    }
+
+} // namespace ntw::detail
+
+namespace ntw::vm {
+
+    template<class Address, class Process>
+    NTW_INLINE result<protection> protect(Address        address,
+                                          std::size_t    size,
+                                          protection     prot,
+                                          const Process& process) noexcept
+    {
+        std::uint32_t old = 0;
+        const auto    s   = ::ntw::detail::protect_pages(
+            ::ntw::detail::unwrap(process),
+            reinterpret_cast<std::uintptr_t>(reinterpret_cast<const void*>(address)),
+            size,
+            prot.get(),
+            old);
+        return { s, protection{ old } };
+    }
+
+    template<class Process>
+    NTW_INLINE status protect(std::span<range> ranges,
+                              protection       prot,
+                              const Process&   process) noexcept
+    {
+        constexpr std::uintptr_t page_mask = 0xFFF;
+
+        std::sort(ranges.begin(), ranges.end(), [](const range& lhs, const range& rhs) {
+            return lhs.begin() < rhs.begin();
+        });
+
+        const auto  handle = ::ntw::detail::unwrap(process);
+        ntw::status result = STATUS_SUCCESS;
+        for(std::size_t i = 0; i < ranges.size();) {
+            // ranges are merged for as long as the next one begins within the run
+            const auto first = i;
+            const auto begin = ranges[i].begin() & ~page_mask;
+            auto       end   = (ranges[i].end() + page_mask) & ~page_mask;
+            for(++i; i < ranges.size() && (ranges[i].begin() & ~page_mask) <= end; ++i)
+                end = std::max(end, (ranges[i].end() + page_mask) & ~page_mask);
+
+            if(begin == end)
+                continue;
+
+            std::uint32_t old;
+            auto          s = ::ntw::detail::protect_pages(
+                handle, begin, end - begin, prot.get(), old);
+
+            // pages of different allocations can not be changed by a single call
+            if(s == STATUS_CONFLICTING_ADDRESSES && i - first > 1) {
+                s = STATUS_SUCCESS;
+                for(auto j = first; j < i; ++j) {
+                    const auto single = ::ntw::detail::protect_pages(
+                        handle, ranges[j].begin(), ranges[j].size, prot.get(), old);
+                    if(s.success())
+                        s = single;
+                }
+            }
+
+            if(result.success())
+                result = s;
+        }
+
+        return result;
+    }
+
+    template<class Address, class Process>
+    NTW_INLINE scoped_protection::scoped_protection(Address        address,
+                                                    std::size_t    size,
+                                                    protection     prot,
+                                                    const Process& process) noexcept
+        : _process(::ntw::detail::unwrap(process))
+        , _address(const_cast<void*>(reinterpret_cast<const void*>(address)))
+        , _size(size)
+    {
+        // only a single old protection is recorded and restored over the whole range
+        _status = ::ntw::detail::single_region(
+            _process, reinterpret_cast<std::uintptr_t>(_address), _size);
+        if(!_status.success())
+            return;
+
+        const auto res = vm::protect(_address, _size, prot, _process);
+        _status        = res.status();
+        _active        = res.success();
+        if(_active)
+            _old = *res;
+    }
+
+    NTW_INLINE scoped_protection::~scoped_protection() noexcept
+    {
+        static_cast<void>(restore());
+    }
+
+    NTW_INLINE scoped_protection::scoped_protection(scoped_protection&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    NTW_INLINE scoped_protection&
+    scoped_protection::operator=(scoped_protection&& other) noexcept
+    {
+        std::swap(_process, other._process);
+        std::swap(_address, other._address);
+        std::swap(_size, other._size);
+        std::swap(_old, other._old);
+        std::swap(_status, other._status);
+        std::swap(_active, other._active);
+        return *this;
+    }
+
+    NTW_INLINE ntw::status scoped_protection::restore() noexcept
+    {
+        if(!_active)
+            return STATUS_SUCCESS;
+
+        _active = false;
+        return vm::protect(_address, _size, _old, _process).status();
+    }
+
+    NTW_INLINE void scoped_protection::release() noexcept { _active = false; }
+
+    NTW_INLINE const ntw::status& scoped_protection::status() const noexcept
+    {
+        return _status;
+    }
+
+    NTW_INLINE protection scoped_protection::old() const noexcept { return _old; }
+
+} // namespace ntw::vm
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../regions.hpp"
+
+namespace ntw::vm {
+
+    template<class Filter>
+    NTW_INLINE bool region_range<Filter>::_query(memory::basic_info& info) noexcept
+    {
+        if(_address >= _until)
+            return false;
+
+        const ntw::status s = NTW_SYSCALL(NtQueryVirtualMemory)(
+            _process,
+            reinterpret_cast<void*>(_address),
+            MemoryBasicInformation,
+            reinterpret_cast<MEMORY_BASIC_INFORMATION*>(&info),
+            sizeof(MEMORY_BASIC_INFORMATION),
+            nullptr);
+
+        if(!s.success()) {
+            // addresses past the highest user address are rejected as invalid
+            if(s != STATUS_INVALID_PARAMETER)
+                _status = s;
+            return false;
+        }
+
+        if(info.base >= _until)
+            return false;
+
+        // the last region may end at the very top of address space
+        const auto end = info.end();
+        _address       = end > info.base ? end : _until;
+        return true;
+    }
+
+    template<class Filter>
+    NTW_INLINE bool region_range<Filter>::_advance() noexcept
+    {
+        while(true) {
+            if(_pending)
+                _current = _next;
+            else if(!_query(_current))
+                return false;
+
+            _pending = false;
+            while(_coalesce && _query(_next)) {
+                if(_next.state != _current.state || _next.type != _current.type ||
+                   _next.protect.get() != _current.protect.get()) {
+                    _pending = true;
+                    break;
+                }
+
+                _current.size += _next.size;
+            }
+
+            if(_filter(static_cast<const memory::basic_info&>(_current)))
+                return true;
+        }
+    }
+
+    template<class Filter>
+    NTW_INLINE region_range<Filter>::region_range(void* process, Filter filter) noexcept
+        : _process(process), _filter(filter)
+    {}
+
+    template<class Filter>
+    NTW_INLINE region_range<Filter>
+               region_range<Filter>::from(std::uintptr_t address) const noexcept
+    {
+        auto copy     = *this;
+        copy._address = address;
+        return copy;
+    }
+
+    template<class Filter>
+    NTW_INLINE region_range<Filter>
+               region_range<Filter>::until(std::uintptr_t address) const noexcept
+    {
+        auto copy   = *this;
+        copy._until = address;
+        return copy;
+    }
+
+    template<class Filter>
+    NTW_INLINE region_range<Filter> region_range<Filter>::coalesced() const noexcept
+    {
+        auto copy      = *this;
+        copy._coalesce = true;
+        return copy;
+    }
+
+    template<class Filter>
+    template<class Predicate>
+    NTW_INLINE auto region_range<Filter>::where(Predicate predicate) const noexcept
+    {
+        auto filter = [first = _filter, predicate](const memory::basic_info& info) {
+            return first(info) && predicate(info);
+        };
+
+        region_range<decltype(filter)> range(_process, filter);
+        range._address  = _address;
+        range._until    = _until;
+        range._coalesce = _coalesce;
+        return range;
+    }
+
+    template<class Filter>
+    NTW_INLINE typename region_range<Filter>::iterator
+    region_range<Filter>::begin() noexcept
+    {
+        return _advance() ? iterator{ this } : iterator{};
+    }
+
+    template<class Filter>
+    NTW_INLINE typename region_range<Filter>::iterator
+    region_range<Filter>::end() noexcept
+    {
+        return {};
+    }
+
+    template<class Filter>
+    NTW_INLINE ntw::status region_range<Filter>::status() const noexcept
+    {
+        return _status;
+    }
+
+    template<class Process>
+    NTW_INLINE region_range<> regions(const Process& process) noexcept
+    {
+        return { ::ntw::detail::unwrap(process), {} };
+    }
+
+} // namespace ntw::vm
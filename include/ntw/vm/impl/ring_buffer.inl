@@ -0,0 +1,189 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../ring_buffer.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+namespace ntw::detail {
+
+    /// \brief Maps the whole section over a placeholder of the same size.
+    NTW_INLINE ntw::status map_over_placeholder(void*       section,
+                                                void*       address,
+                                                std::size_t size) noexcept
+    {
+        SIZE_T view_size = size;
+        return NTW_SYSCALL(NtMapViewOfSectionEx)(section,
+                                                 NtCurrentProcess(),
+                                                 &address,
+                                                 nullptr,
+                                                 &view_size,
+                                                 MEM_REPLACE_PLACEHOLDER,
+                                                 PAGE_READWRITE,
+                                                 nullptr,
+                                                 0);
+    }
+
+} // namespace ntw::detail
+
+namespace ntw::vm {
+
+    NTW_INLINE void ring_buffer::_destroy() noexcept
+    {
+        if(_data) {
+            static_cast<void>(vm::unmap(_data));
+            static_cast<void>(vm::unmap(_data + _size));
+        }
+
+        _data = nullptr;
+        _size = 0;
+        _producer.head.store(0, std::memory_order_relaxed);
+        _producer.cached_tail = 0;
+        _consumer.tail.store(0, std::memory_order_relaxed);
+        _consumer.cached_head = 0;
+    }
+
+    NTW_INLINE ring_buffer::~ring_buffer() noexcept { _destroy(); }
+
+    NTW_INLINE status ring_buffer::create(std::size_t size) noexcept
+    {
+        _destroy();
+
+        if(size > (std::numeric_limits<std::size_t>::max() >> 2))
+            return STATUS_INVALID_PARAMETER;
+        // a power of 2 lets the indices be masked instead of divided
+        size = std::bit_ceil(std::max(size, granularity));
+
+        LARGE_INTEGER max_size;
+        max_size.QuadPart = static_cast<LONGLONG>(size);
+
+        void*  section = nullptr;
+        status s       = NTW_SYSCALL(NtCreateSection)(&section,
+                                                SECTION_MAP_READ | SECTION_MAP_WRITE,
+                                                nullptr,
+                                                &max_size,
+                                                PAGE_READWRITE,
+                                                SEC_COMMIT,
+                                                nullptr);
+        if(!s.success())
+            return s;
+
+        const auto placeholder = vm::allocate().reserve_placeholder().reserve(
+            size * 2, protection::no_access());
+        if(!placeholder) {
+            NTW_SYSCALL(NtClose)(section);
+            return placeholder.status();
+        }
+
+        // both halves become placeholders of their own that are replaced by the views
+        const auto  base   = static_cast<std::uint8_t*>(*placeholder);
+        std::size_t mapped = 0;
+        s                  = vm::split_placeholder(base, size);
+        for(; s.success() && mapped < 2; ++mapped) {
+            s = ::ntw::detail::map_over_placeholder(section, base + mapped * size, size);
+            if(!s.success())
+                break;
+        }
+
+        // the views keep the section alive
+        NTW_SYSCALL(NtClose)(section);
+
+        if(!s.success()) {
+            static_cast<void>(mapped ? vm::unmap(base) : vm::release(base));
+            static_cast<void>(vm::release(base + size));
+            return s;
+        }
+
+        _data = base;
+        _size = size;
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE std::span<std::uint8_t> ring_buffer::write_area(std::size_t size) noexcept
+    {
+        const auto head = _producer.head.load(std::memory_order_relaxed);
+
+        // the consumer is only consulted when the last known tail is not enough
+        if(size > _size - (head - _producer.cached_tail)) {
+            _producer.cached_tail = _consumer.tail.load(std::memory_order_acquire);
+            if(size > _size - (head - _producer.cached_tail))
+                return {};
+        }
+
+        return { _data + (head & (_size - 1)), size };
+    }
+
+    NTW_INLINE void ring_buffer::produce(std::size_t size) noexcept
+    {
+        const auto head = _producer.head.load(std::memory_order_relaxed);
+        _producer.head.store(head + size, std::memory_order_release);
+    }
+
+    NTW_INLINE bool ring_buffer::write(const void* data, std::size_t size) noexcept
+    {
+        const auto area = write_area(size);
+        if(area.size() != size)
+            return false;
+
+        std::memcpy(area.data(), data, size);
+        produce(size);
+        return true;
+    }
+
+    NTW_INLINE std::span<const std::uint8_t> ring_buffer::read_area() noexcept
+    {
+        const auto tail = _consumer.tail.load(std::memory_order_relaxed);
+        if(_consumer.cached_head == tail)
+            _consumer.cached_head = _producer.head.load(std::memory_order_acquire);
+
+        return { _data + (tail & (_size - 1)), _consumer.cached_head - tail };
+    }
+
+    NTW_INLINE void ring_buffer::consume(std::size_t size) noexcept
+    {
+        const auto tail = _consumer.tail.load(std::memory_order_relaxed);
+        _consumer.tail.store(tail + size, std::memory_order_release);
+    }
+
+    NTW_INLINE bool ring_buffer::read(void* buffer, std::size_t size) noexcept
+    {
+        const auto tail = _consumer.tail.load(std::memory_order_relaxed);
+        if(size > _consumer.cached_head - tail) {
+            _consumer.cached_head = _producer.head.load(std::memory_order_acquire);
+            if(size > _consumer.cached_head - tail)
+                return false;
+        }
+
+        std::memcpy(buffer, _data + (tail & (_size - 1)), size);
+        _consumer.tail.store(tail + size, std::memory_order_release);
+        return true;
+    }
+
+    NTW_INLINE std::size_t ring_buffer::capacity() const noexcept { return _size; }
+
+    NTW_INLINE std::size_t ring_buffer::size() const noexcept
+    {
+        // tail is loaded first so it can never be ahead of head
+        const auto tail = _consumer.tail.load(std::memory_order_acquire);
+        return _producer.head.load(std::memory_order_acquire) - tail;
+    }
+
+    NTW_INLINE std::uint8_t* ring_buffer::data() const noexcept { return _data; }
+
+} // namespace ntw::vm
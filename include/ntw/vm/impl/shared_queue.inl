@@ -0,0 +1,355 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../shared_queue.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace ntw::detail {
+
+    // every record starts with its size, a size of ~0 marks the unused space at the
+    // end of the buffer when a record had to be moved to its start
+    constexpr std::uint64_t queue_record_header = sizeof(std::uint64_t);
+    constexpr std::uint64_t queue_skip_record   = ~std::uint64_t{ 0 };
+
+    NTW_INLINE constexpr std::uint64_t queue_record_size(std::uint64_t size) noexcept
+    {
+        return (size + queue_record_header + 7) & ~std::uint64_t{ 7 };
+    }
+
+} // namespace ntw::detail
+
+namespace ntw::vm {
+
+    NTW_INLINE status shared_queue::_assign(ob::section      section,
+                                            ob::section_view view,
+                                            ob::event        not_empty,
+                                            ob::event        not_full) noexcept
+    {
+        if(view.size() < sizeof(shared_state))
+            return STATUS_INVALID_PARAMETER;
+
+        // the size is copied so the other side can't make us read past the view
+        const auto state    = reinterpret_cast<shared_state*>(view.data());
+        const auto capacity = state->capacity;
+        if(state->magic != magic_value || capacity < 0x1000 ||
+           !std::has_single_bit(capacity) ||
+           capacity > view.size() - sizeof(shared_state))
+            return STATUS_INVALID_PARAMETER;
+
+        _state    = state;
+        _data     = view.data() + sizeof(shared_state);
+        _capacity = capacity;
+
+        const auto tail = state->tail.load(std::memory_order_acquire);
+        _cached_tail.store(tail, std::memory_order_relaxed);
+        _cached_committed = tail;
+        _front_size       = 0;
+
+        _section   = std::move(section);
+        _view      = std::move(view);
+        _not_empty = std::move(not_empty);
+        _not_full  = std::move(not_full);
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE void shared_queue::_advance_tail(std::uint64_t tail) noexcept
+    {
+        _state->tail.store(tail, std::memory_order_release);
+
+        // pairs with the fence in _wait so either the waiter sees the new tail or
+        // we see the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(_state->producers_waiting.load(std::memory_order_relaxed))
+            static_cast<void>(_not_full.set());
+    }
+
+    template<class Ready>
+    NTW_INLINE status shared_queue::_wait(std::atomic<std::uint32_t>& waiting,
+                                          const ob::event&            event,
+                                          Ready                       ready) noexcept
+    {
+        while(!ready()) {
+            waiting.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // checked again as the other side might have missed the waiter
+            const bool ready_now = ready();
+            status     s         = STATUS_SUCCESS;
+            if(!ready_now)
+                s = event.wait();
+
+            waiting.fetch_sub(1, std::memory_order_relaxed);
+            if(ready_now)
+                break;
+            if(!s.success())
+                return s;
+        }
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE status shared_queue::create(std::size_t capacity) noexcept
+    {
+        if(capacity > (std::numeric_limits<std::size_t>::max() >> 2))
+            return STATUS_INVALID_PARAMETER;
+        // a power of 2 lets the indices be masked instead of divided
+        capacity = std::bit_ceil(std::max(capacity, std::size_t{ 0x1000 }));
+
+        auto section = ob::section::create(sizeof(shared_state) + capacity);
+        if(!section)
+            return section.status();
+
+        auto view = section->map();
+        if(!view)
+            return view.status();
+
+        auto not_empty = ob::event::create(SynchronizationEvent);
+        if(!not_empty)
+            return not_empty.status();
+
+        auto not_full = ob::event::create(SynchronizationEvent);
+        if(!not_full)
+            return not_full.status();
+
+        const auto state = ::new(view->data()) shared_state{};
+        state->magic     = magic_value;
+        state->capacity  = capacity;
+
+        return _assign(std::move(*section),
+                       std::move(*view),
+                       std::move(*not_empty),
+                       std::move(*not_full));
+    }
+
+    NTW_INLINE status shared_queue::attach(ob::section section,
+                                           ob::event   not_empty,
+                                           ob::event   not_full) noexcept
+    {
+        auto view = section.map();
+        if(!view)
+            return view.status();
+
+        return _assign(std::move(section),
+                       std::move(*view),
+                       std::move(not_empty),
+                       std::move(not_full));
+    }
+
+    NTW_INLINE std::size_t shared_queue::max_message_size() const noexcept
+    {
+        // a record moved to the start leaves less than its own size unused at the end
+        // so records up to half of the capacity always fit into an empty queue
+        if(!_capacity)
+            return 0;
+        return _capacity / 2 - ::ntw::detail::queue_record_header;
+    }
+
+    NTW_INLINE shared_queue::reservation
+    shared_queue::try_reserve(std::size_t size) noexcept
+    {
+        reservation r;
+        if(!_state || size > max_message_size())
+            return r;
+
+        const auto    total    = ::ntw::detail::queue_record_size(size);
+        auto          position = _state->reserved.load(std::memory_order_relaxed);
+        std::uint64_t needed;
+        do {
+            const auto offset = position & (_capacity - 1);
+            needed = offset + total > _capacity ? _capacity - offset + total : total;
+
+            // the consumer is only consulted when the last known tail is not enough
+            const auto cached = _cached_tail.load(std::memory_order_acquire);
+            if(position + needed > cached + _capacity) {
+                const auto tail = _state->tail.load(std::memory_order_acquire);
+                _cached_tail.store(tail, std::memory_order_release);
+                if(position + needed > tail + _capacity)
+                    return r;
+            }
+        } while(!_state->reserved.compare_exchange_weak(
+            position, position + needed, std::memory_order_relaxed));
+
+        auto record = position;
+        if(needed != total) {
+            std::memcpy(_data + (position & (_capacity - 1)),
+                        &::ntw::detail::queue_skip_record,
+                        ::ntw::detail::queue_record_header);
+            record += needed - total;
+        }
+
+        const auto          offset = record & (_capacity - 1);
+        const std::uint64_t header = size;
+        std::memcpy(_data + offset, &header, sizeof(header));
+
+        r.data  = { _data + offset + ::ntw::detail::queue_record_header, size };
+        r.begin = position;
+        r.end   = position + needed;
+        return r;
+    }
+
+    NTW_INLINE void shared_queue::commit(const reservation& r) noexcept
+    {
+        // acquire makes the records of earlier producers visible to the consumer too
+        while(_state->committed.load(std::memory_order_acquire) != r.begin)
+            NTW_SYSCALL(NtYieldExecution)();
+
+        _state->committed.store(r.end, std::memory_order_release);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(_state->consumer_waiting.load(std::memory_order_relaxed))
+            static_cast<void>(_not_empty.set());
+    }
+
+    NTW_INLINE bool shared_queue::try_push(const void* data, std::size_t size) noexcept
+    {
+        const auto r = try_reserve(size);
+        if(!r)
+            return false;
+
+        if(size)
+            std::memcpy(r.data.data(), data, size);
+        commit(r);
+        return true;
+    }
+
+    NTW_INLINE status shared_queue::push(const void* data, std::size_t size) noexcept
+    {
+        if(!_state)
+            return STATUS_INVALID_HANDLE;
+        if(size > max_message_size())
+            return STATUS_INVALID_PARAMETER;
+
+        reservation  r;
+        const status s = _wait(_state->producers_waiting, _not_full, [&] {
+            r = try_reserve(size);
+            return static_cast<bool>(r);
+        });
+        if(!s.success())
+            return s;
+
+        if(size)
+            std::memcpy(r.data.data(), data, size);
+        commit(r);
+        return STATUS_SUCCESS;
+    }
+
+    NTW_INLINE result<std::span<const std::uint8_t>> shared_queue::front() noexcept
+    {
+        if(!_state)
+            return { STATUS_NO_MORE_ENTRIES };
+
+        auto tail = _state->tail.load(std::memory_order_relaxed);
+        for(;;) {
+            if(_cached_committed == tail) {
+                _cached_committed = _state->committed.load(std::memory_order_acquire);
+                if(_cached_committed == tail)
+                    return { STATUS_NO_MORE_ENTRIES };
+            }
+
+            // nothing written by the other side is trusted to stay within the buffer
+            const auto available = _cached_committed - tail;
+            const auto offset    = tail & (_capacity - 1);
+            if(available > _capacity)
+                return { STATUS_DATA_ERROR };
+
+            std::uint64_t size;
+            std::memcpy(&size, _data + offset, sizeof(size));
+            if(size == ::ntw::detail::queue_skip_record) {
+                if(_capacity - offset > available)
+                    return { STATUS_DATA_ERROR };
+
+                tail += _capacity - offset;
+                _advance_tail(tail);
+                continue;
+            }
+
+            if(size > _capacity)
+                return { STATUS_DATA_ERROR };
+
+            const auto total = ::ntw::detail::queue_record_size(size);
+            if(total > available || offset + total > _capacity)
+                return { STATUS_DATA_ERROR };
+
+            _front_size = total;
+            return { STATUS_SUCCESS,
+                     std::span<const std::uint8_t>{
+                         _data + offset + ::ntw::detail::queue_record_header,
+                         static_cast<std::size_t>(size) } };
+        }
+    }
+
+    NTW_INLINE result<std::span<const std::uint8_t>> shared_queue::wait_front() noexcept
+    {
+        if(!_state)
+            return { STATUS_INVALID_HANDLE };
+
+        result<std::span<const std::uint8_t>> res;
+
+        const status s = _wait(_state->consumer_waiting, _not_empty, [&] {
+            res = front();
+            return res.status() != STATUS_NO_MORE_ENTRIES;
+        });
+        if(!s.success())
+            return { s };
+        return res;
+    }
+
+    NTW_INLINE void shared_queue::pop() noexcept
+    {
+        if(!_front_size && !front().success())
+            return;
+
+        const auto tail = _state->tail.load(std::memory_order_relaxed);
+        _advance_tail(tail + std::exchange(_front_size, 0));
+    }
+
+    NTW_INLINE std::size_t shared_queue::capacity() const noexcept
+    {
+        return static_cast<std::size_t>(_capacity);
+    }
+
+    NTW_INLINE std::size_t shared_queue::size() const noexcept
+    {
+        if(!_state)
+            return 0;
+
+        // tail is loaded first so it can never be ahead of the commit
+        const auto tail = _state->tail.load(std::memory_order_acquire);
+        return static_cast<std::size_t>(
+            _state->committed.load(std::memory_order_acquire) - tail);
+    }
+
+    NTW_INLINE const ob::section& shared_queue::section() const noexcept
+    {
+        return _section;
+    }
+
+    NTW_INLINE const ob::event& shared_queue::not_empty_event() const noexcept
+    {
+        return _not_empty;
+    }
+
+    NTW_INLINE const ob::event& shared_queue::not_full_event() const noexcept
+    {
+        return _not_full;
+    }
+
+} // namespace ntw::vm
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../working_set.hpp"
+#include <bit>
+#include <cstring>
+
+namespace ntw::vm {
+
+    NTW_INLINE std::size_t residency_map::_words() const noexcept
+    {
+        return (_count + 63) / 64;
+    }
+
+    NTW_INLINE std::span<const std::uint64_t>
+               residency_map::_bitmap(std::size_t i) const noexcept
+    {
+        return { _bits.as<std::uint64_t>() + i * _words(), _words() };
+    }
+
+    NTW_INLINE bool residency_map::_test(std::size_t bitmap,
+                                         std::size_t page) const noexcept
+    {
+        return (_bitmap(bitmap)[page / 64] >> (page % 64)) & 1;
+    }
+
+    template<class Process>
+    NTW_INLINE status residency_map::_query(const Process& process) noexcept
+    {
+        using info_type = memory::working_set_ex_info;
+
+        if(!_count)
+            return STATUS_SUCCESS;
+
+        const auto words = _words();
+        if(const auto s = _bits.reserve(3 * words * sizeof(std::uint64_t));
+           !s.success())
+            return s;
+        if(const auto s = _nodes.reserve(_count); !s.success())
+            return s;
+
+        const auto entries = _entries.as<info_type>();
+        const status s     = NTW_SYSCALL(NtQueryVirtualMemory)(
+            ::ntw::detail::unwrap(process),
+            nullptr,
+            info_type::info_class,
+            reinterpret_cast<typename info_type::native_type*>(entries),
+            _count * sizeof(typename info_type::native_type),
+            nullptr);
+        if(!s.success()) {
+            _count = 0;
+            return s;
+        }
+
+        const auto bits = _bits.as<std::uint64_t>();
+        std::memset(bits, 0, 3 * words * sizeof(std::uint64_t));
+
+        const auto nodes = _nodes.data();
+        for(std::size_t i = 0; i < _count; ++i) {
+            const auto& e     = entries[i];
+            const auto  valid = e.is_valid();
+            const auto  word  = i / 64;
+            const auto  shift = i % 64;
+
+            bits[word] |= std::uint64_t{ valid } << shift;
+            bits[words + word] |= std::uint64_t{ e.is_shared() } << shift;
+            bits[2 * words + word] |= std::uint64_t{ valid && e.is_locked() } << shift;
+            nodes[i] = valid ? static_cast<std::uint8_t>(e.node()) : 0;
+        }
+
+        return STATUS_SUCCESS;
+    }
+
+    template<class Process>
+    NTW_INLINE status residency_map::query(std::span<const std::uintptr_t> addresses,
+                                           const Process& process) noexcept
+    {
+        using info_type = memory::working_set_ex_info;
+
+        _count = 0;
+        if(const auto s = _entries.reserve(addresses.size() * sizeof(info_type));
+           !s.success())
+            return s;
+
+        const auto entries = _entries.as<info_type>();
+        for(std::size_t i = 0; i < addresses.size(); ++i)
+            entries[i] = { addresses[i], 0 };
+
+        _count = addresses.size();
+        return _query(process);
+    }
+
+    template<class Address, class Process>
+    NTW_INLINE status residency_map::query(Address        address,
+                                           std::size_t    size,
+                                           const Process& process) noexcept
+    {
+        using info_type = memory::working_set_ex_info;
+
+        const auto begin =
+            reinterpret_cast<std::uintptr_t>(reinterpret_cast<const void*>(address));
+        const auto first = begin & ~(page_size - 1);
+        const auto last  = begin + size;
+        const auto count = size ? (last - first + page_size - 1) / page_size : 0;
+
+        _count = 0;
+        if(const auto s = _entries.reserve(count * sizeof(info_type)); !s.success())
+            return s;
+
+        const auto entries = _entries.as<info_type>();
+        for(std::size_t i = 0; i < count; ++i)
+            entries[i] = { first + i * page_size, 0 };
+
+        _count = count;
+        return _query(process);
+    }
+
+    NTW_INLINE std::size_t residency_map::size() const noexcept { return _count; }
+
+    NTW_INLINE bool residency_map::resident(std::size_t i) const noexcept
+    {
+        return _test(0, i);
+    }
+
+    NTW_INLINE bool residency_map::shared(std::size_t i) const noexcept
+    {
+        return _test(1, i);
+    }
+
+    NTW_INLINE bool residency_map::locked(std::size_t i) const noexcept
+    {
+        return _test(2, i);
+    }
+
+    NTW_INLINE std::uint8_t residency_map::node(std::size_t i) const noexcept
+    {
+        return _nodes.data()[i];
+    }
+
+    NTW_INLINE std::span<const std::uint64_t> residency_map::resident_bits() const
+        noexcept
+    {
+        return _bitmap(0);
+    }
+
+    NTW_INLINE std::span<const std::uint64_t> residency_map::shared_bits() const
+        noexcept
+    {
+        return _bitmap(1);
+    }
+
+    NTW_INLINE std::span<const std::uint64_t> residency_map::locked_bits() const
+        noexcept
+    {
+        return _bitmap(2);
+    }
+
+    NTW_INLINE std::span<const std::uint8_t> residency_map::nodes() const noexcept
+    {
+        return { _nodes.data(), _count };
+    }
+
+    NTW_INLINE std::size_t residency_map::resident_count() const noexcept
+    {
+        std::size_t count = 0;
+        for(const auto word : resident_bits())
+            count += std::popcount(word);
+        return count;
+    }
+
+    NTW_INLINE std::span<const memory::working_set_ex_info>
+               residency_map::entries() const noexcept
+    {
+        return { _entries.as<memory::working_set_ex_info>(), _count };
+    }
+
+} // namespace ntw::vm
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "allocation.hpp"
+#include "../ob/token.hpp"
+
+namespace ntw::vm {
+
+    /// \brief Memory returned by large_page_alloc.
+    struct large_page_allocation {
+        void*       address = nullptr;
+        std::size_t size    = 0; ///< The size rounded to the page size used.
+        /// \brief Success if the memory is backed by large pages, otherwise the reason
+        ///        for falling back to regular pages.
+        status fallback_reason;
+
+        /// \brief Returns whether the memory is backed by large pages.
+        NTW_INLINE bool large_pages() const noexcept { return fallback_reason.success(); }
+    };
+
+    /// \brief Returns the size of a large page or 0 if they are not supported.
+    NTW_INLINE std::size_t large_page_minimum() noexcept;
+
+    /// \brief Allocates committed read write memory backed by large pages, falling back
+    ///        to regular pages if that is not possible.
+    /// \param size The size of allocation, rounded up to the large page minimum.
+    /// \note The lock memory privilege is enabled through ob::enable_privilege_once
+    ///       on first use. The memory is freed with vm::release.
+    /// \returns An error only if the fallback allocation fails too.
+    template<class Process = void*>
+    NTW_INLINE result<large_page_allocation>
+               large_page_alloc(std::size_t    size,
+                                const Process& process = NtCurrentProcess()) noexcept;
+
+} // namespace ntw::vm
+
+#include "impl/large_pages.inl"
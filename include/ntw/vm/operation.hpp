@@ -38,6 +38,14 @@ namespace ntw::vm {
                                std::size_t    size    = 0,
                                const Process& process = NtCurrentProcess()) noexcept;
 
+    /// \brief Splits a placeholder so that [addr, addr + size) becomes a placeholder
+    ///        of its own which can then be replaced separately.
+    template<class Address, class Process = void*>
+    NTW_INLINE status
+    split_placeholder(Address        addr,
+                      std::size_t    size,
+                      const Process& process = NtCurrentProcess()) noexcept;
+
     template<class Address, class Process = void*>
     NTW_INLINE status unmap(Address        addr,
                             const Process& process = NtCurrentProcess()) noexcept;
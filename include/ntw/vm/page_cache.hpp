@@ -0,0 +1,113 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "../detail/unwrap.hpp"
+#include "../result.hpp"
+#include <algorithm>
+
+namespace ntw::vm {
+
+    /// \brief Read-through cache of whole pages of memory of a process. Pages are
+    ///        copied into a preallocated arena and the least recently used page is
+    ///        evicted when the arena is full.
+    /// \note Cached pages are never refreshed on their own. Call invalidate() whenever
+    ///       the cached data may be stale, for example between passes over the target.
+    class page_cache {
+        struct entry {
+            std::uintptr_t page; // not page aligned for entries without a page
+            std::uint64_t  generation;
+            std::uint32_t  prev;
+            std::uint32_t  next;
+        };
+
+        // entry 0 is the head of a circular list ordered from the most recently used
+        ntw::detail::growable_buffer _arena;
+        ntw::detail::growable_buffer _entries;
+        ntw::detail::growable_buffer _table; // index of entry, 0 marks an empty slot
+        void*                        _process;
+        std::size_t                  _capacity   = 0;
+        std::size_t                  _mask       = 0;
+        std::uint64_t                _generation = 1;
+
+        constexpr static std::uintptr_t _no_page = 1;
+
+        NTW_INLINE constexpr static std::size_t _hash(std::uintptr_t page) noexcept;
+
+        NTW_INLINE entry* _entry(std::uint32_t idx) const noexcept;
+
+        NTW_INLINE void _unlink(std::uint32_t idx) const noexcept;
+
+        NTW_INLINE void _link_front(std::uint32_t idx) const noexcept;
+
+        NTW_INLINE void _link_back(std::uint32_t idx) const noexcept;
+
+        NTW_INLINE std::uint32_t _find(std::uintptr_t page) const noexcept;
+
+        NTW_INLINE void _insert(std::uint32_t idx) const noexcept;
+
+        NTW_INLINE void _erase(std::uint32_t idx) const noexcept;
+
+        NTW_INLINE ntw::result<const std::uint8_t*> _page(std::uintptr_t page) noexcept;
+
+    public:
+        constexpr static std::size_t page_size = 0x1000;
+
+        /// \brief Constructs the cache without allocating. Until reserve() is called
+        ///        every read goes straight to the process.
+        template<class Process = void*>
+        NTW_INLINE explicit page_cache(
+            const Process& process = NtCurrentProcess()) noexcept;
+
+        /// \brief Allocates the arena for the given amount of pages, dropping every
+        ///        cached page.
+        NTW_INLINE status reserve(std::size_t pages) noexcept;
+
+        /// \brief Reads memory at given address into given buffer, copying the missing
+        ///        or stale pages from the process first.
+        /// \param addr Address of memory to read from.
+        /// \param buffer Buffer to read into.
+        /// \param size Size of buffer.
+        /// \returns The status of the first failed page read.
+        /// \note Unreadable pages are not cached.
+        template<class Address>
+        NTW_INLINE status read_mem(Address addr, void* buffer, std::size_t size) noexcept;
+
+        /// \brief Reads memory at given address into given range.
+        /// \param addr Address of memory to read from.
+        /// \param range The range of memory to read into.
+        template<class Address, class Range>
+        NTW_INLINE status read_mem(Address addr, Range&& range) noexcept;
+
+        /// \brief Marks every cached page as stale. The pages are read again on their
+        ///        next use.
+        NTW_INLINE void invalidate() noexcept;
+
+        /// \brief Marks the cached pages that overlap the given range as stale.
+        template<class Address>
+        NTW_INLINE void invalidate(Address addr, std::size_t size) noexcept;
+
+        /// \brief Returns the current generation which is bumped by invalidate().
+        NTW_INLINE std::uint64_t generation() const noexcept;
+
+        /// \brief Returns the maximum amount of cached pages.
+        NTW_INLINE std::size_t capacity() const noexcept;
+    };
+
+} // namespace ntw::vm
+
+#include "impl/page_cache.inl"
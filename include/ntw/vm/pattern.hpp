@@ -0,0 +1,79 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/simd.hpp"
+#include "../result.hpp"
+#include <string_view>
+
+namespace ntw::vm {
+
+    /// \brief A byte pattern where every byte is compared under a mask.
+    /// \note Matching is done on plain buffers so the pattern can be used without a
+    ///       process.
+    class pattern {
+    public:
+        /// \brief The maximum amount of bytes in a pattern.
+        constexpr static std::size_t max_size = 64;
+
+        /// \brief Returned by find if there is no match.
+        constexpr static std::size_t npos = ~std::size_t{ 0 };
+
+    private:
+        std::uint8_t _bytes[max_size] = {}; // pre-masked
+        std::uint8_t _masks[max_size] = {};
+        std::size_t  _size            = 0;
+        // offsets of the first and last bytes without wildcards, used as a filter
+        std::size_t _first    = 0;
+        std::size_t _last     = 0;
+        bool        _anchored = false;
+
+        NTW_INLINE status _push(std::uint8_t byte, std::uint8_t mask) noexcept;
+
+    public:
+        NTW_INLINE constexpr pattern() = default;
+
+        /// \brief Parses an IDA style pattern such as "48 8B ?? ?? 4? 0F".
+        /// \note "?" and "??" match any byte, a '?' in place of one hex digit matches
+        ///       any value of that nibble.
+        /// \returns The pattern or STATUS_INVALID_PARAMETER if the pattern is empty, too
+        ///          long or malformed.
+        NTW_INLINE static result<pattern> parse(std::string_view ida) noexcept;
+
+        /// \brief Creates a pattern from bytes and a code style mask such as "xx??x".
+        /// \note 'x' bytes have to match and '?' bytes match anything.
+        /// \returns The pattern or STATUS_INVALID_PARAMETER if the sizes differ, the
+        ///          pattern is empty or too long or the mask has other characters.
+        NTW_INLINE static result<pattern> from_mask(std::span<const std::uint8_t> bytes,
+                                                    std::string_view mask) noexcept;
+
+        /// \brief Returns the amount of bytes in the pattern.
+        NTW_INLINE std::size_t size() const noexcept;
+
+        /// \brief Checks whether size() bytes starting at data match the pattern.
+        NTW_INLINE bool matches(const std::uint8_t* data) const noexcept;
+
+        /// \brief Finds the first match that starts at or after the given offset.
+        /// \param data The buffer to search.
+        /// \param from The offset to start searching from.
+        /// \returns The offset of match or npos.
+        NTW_INLINE std::size_t find(std::span<const std::uint8_t> data,
+                                    std::size_t from = 0) const noexcept;
+    };
+
+} // namespace ntw::vm
+
+#include "impl/pattern.inl"
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "pattern.hpp"
+#include "regions.hpp"
+#include <atomic>
+
+namespace ntw::detail {
+
+    /// \brief A piece of readable memory scanned by a single worker. The bytes after
+    ///        size overlap the next chunk so matches crossing the border are found.
+    struct scan_chunk {
+        std::uintptr_t address;
+        std::size_t    size;
+        std::size_t    read_size;
+    };
+
+    template<class Callback>
+    struct scan_context {
+        void*                        process;
+        std::span<const vm::pattern> patterns;
+        Callback*                    callback;
+        const scan_chunk*            chunks;
+        std::size_t                  count;
+        std::size_t                  read_size;
+        std::atomic<std::size_t>     next   = 0;
+        std::atomic<std::int32_t>    status = STATUS_SUCCESS;
+    };
+
+} // namespace ntw::detail
+
+namespace ntw::vm {
+
+    /// \brief A match found by pattern_scanner.
+    struct pattern_match {
+        std::uintptr_t address;
+        std::size_t    pattern; // index of the matched pattern
+    };
+
+    /// \brief Scans the readable committed memory of a process for byte patterns.
+    ///
+    /// Adjacent readable regions are split into chunks which are read with a single
+    /// call each. The chunks are spread over a pool of workers that consists of the
+    /// calling thread and workers() - 1 threads created for the duration of scan.
+    class pattern_scanner {
+        std::size_t _workers    = 1;
+        std::size_t _chunk_size = 0x100000;
+
+        template<class Context>
+        NTW_INLINE static NTSTATUS NTAPI _worker(void* argument) noexcept;
+
+    public:
+        constexpr static std::size_t max_workers = 64;
+
+        /// \brief Sets the amount of threads scanning the memory, clamped to
+        ///        [1, max_workers].
+        /// \note If creating a thread fails the scan continues with fewer workers.
+        NTW_INLINE pattern_scanner& workers(std::size_t count) noexcept;
+
+        /// \brief Sets the amount of bytes read and scanned at once by a worker.
+        NTW_INLINE pattern_scanner& chunk_size(std::size_t size) noexcept;
+
+        /// \brief Finds every match of every pattern.
+        /// \param patterns The patterns to look for.
+        /// \param callback Called with a pattern_match for every match. Invoked
+        ///                 concurrently from every worker and in no particular order.
+        /// \returns The status of failed region query or allocation.
+        /// \note Chunks that can no longer be read by the time a worker gets to them,
+        ///       for example because the memory was freed, are skipped.
+        template<class Callback, class Process = void*>
+        NTW_INLINE status
+        scan(std::span<const pattern> patterns,
+             Callback                 callback,
+             const Process&           process = NtCurrentProcess()) const noexcept;
+    };
+
+} // namespace ntw::vm
+
+#include "impl/pattern_scan.inl"
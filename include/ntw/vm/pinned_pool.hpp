@@ -0,0 +1,88 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "allocation.hpp"
+#include "operation.hpp"
+#include "../ob/token.hpp"
+#include <atomic>
+
+namespace ntw::vm {
+
+    /// \brief Pool of fixed size buffers that are locked into the working set, so
+    ///        touching them never soft faults even after the working set was trimmed.
+    ///        Buffers are handed out and returned through a lock free free list.
+    ///
+    /// pinned_pool pool;
+    /// pool.create(0x2000, 64);
+    /// if(const auto buffer = pool.acquire()) {
+    ///     handle_request(buffer, pool.buffer_size());
+    ///     pool.release(buffer);
+    /// }
+    /// \note Only create and the destructor are not thread safe.
+    class pinned_pool {
+        // the index of the first free buffer + 1 in the low half and a counter that
+        // changes with every update in the high half, so a head that was popped and
+        // pushed back in the meantime is not mistaken for an unchanged one
+        alignas(64) std::atomic<std::uint64_t> _head = 0;
+
+        alignas(64) std::uint8_t* _data = nullptr;
+        std::atomic<std::uint32_t>* _next        = nullptr; // next free index + 1
+        std::size_t                 _buffer_size = 0;
+        std::size_t                 _count       = 0;
+
+        NTW_INLINE void _destroy() noexcept;
+
+    public:
+        NTW_INLINE pinned_pool() noexcept = default;
+
+        NTW_INLINE ~pinned_pool() noexcept;
+
+        pinned_pool(const pinned_pool&) = delete;
+        pinned_pool& operator=(const pinned_pool&) = delete;
+
+        /// \brief Creates the pool, destroying the previous one.
+        /// \param buffer_size The size of every buffer, rounded up to a multiple of 64
+        ///        so buffers don't share cache lines.
+        /// \param count The amount of buffers.
+        /// \note If locking fails due to the working set minimum being too small, it is
+        ///       raised by the size of the pool after enabling the increase working set
+        ///       privilege through ob::enable_privilege_once.
+        NTW_INLINE status create(std::size_t buffer_size, std::size_t count) noexcept;
+
+        /// \brief Takes a buffer from the pool.
+        /// \returns nullptr if all buffers are in use.
+        NTW_INLINE void* acquire() noexcept;
+
+        /// \brief Returns a buffer previously acquired from this pool.
+        NTW_INLINE void release(void* buffer) noexcept;
+
+        /// \brief Checks whether the address lies within a buffer of this pool.
+        NTW_INLINE bool contains(const void* address) const noexcept;
+
+        /// \brief Returns the size of every buffer.
+        NTW_INLINE std::size_t buffer_size() const noexcept;
+
+        /// \brief Returns the amount of buffers in the pool.
+        NTW_INLINE std::size_t count() const noexcept;
+
+        /// \brief Returns the first buffer.
+        NTW_INLINE void* data() const noexcept;
+    };
+
+} // namespace ntw::vm
+
+#include "impl/pinned_pool.inl"
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "protection.hpp"
+#include "range.hpp"
+#include "../result.hpp"
+#include <span>
+
+namespace ntw::vm {
+
+    /// \brief Changes the protection of pages in [address, address + size).
+    /// \returns The previous protection of the first page.
+    template<class Address, class Process = void*>
+    NTW_INLINE result<protection>
+               protect(Address        address,
+                       std::size_t    size,
+                       protection     prot,
+                       const Process& process = NtCurrentProcess()) noexcept;
+
+    /// \brief Changes the protection of every range with as few syscalls as possible.
+    ///        Ranges are sorted by address and the ones whose pages touch or overlap
+    ///        are changed together.
+    /// \param ranges The ranges to change. They are sorted in place.
+    /// \returns The status of the first failed change. Other ranges are still changed.
+    /// \note Merged ranges that turn out to span several allocations are retried one
+    ///       range at a time.
+    template<class Process = void*>
+    NTW_INLINE status protect(std::span<range> ranges,
+                              protection       prot,
+                              const Process&   process = NtCurrentProcess()) noexcept;
+
+    /// \brief Changes the protection of pages and restores the previous protection when
+    ///        it goes out of scope.
+    ///
+    /// {
+    ///     scoped_protection writable(code, size, protection::read_write());
+    ///     if(!writable.status().success())
+    ///         return writable.status();
+    ///     std::memcpy(code, bytes, size);
+    /// }
+    /// \note Only a single previous protection is recorded, so every page of the range
+    ///       must share it. Ranges spanning pages with different protections are rejected
+    ///       with STATUS_CONFLICTING_ADDRESSES and left unchanged.
+    class scoped_protection {
+        void*       _process = nullptr;
+        void*       _address = nullptr;
+        std::size_t _size    = 0;
+        protection  _old;
+        ntw::status _status = STATUS_INVALID_HANDLE;
+        bool        _active = false; // whether the old protection is yet to be restored
+
+    public:
+        NTW_INLINE scoped_protection() noexcept = default;
+
+        template<class Address, class Process = void*>
+        NTW_INLINE
+        scoped_protection(Address        address,
+                          std::size_t    size,
+                          protection     prot,
+                          const Process& process = NtCurrentProcess()) noexcept;
+
+        NTW_INLINE ~scoped_protection() noexcept;
+
+        NTW_INLINE scoped_protection(scoped_protection&& other) noexcept;
+
+        NTW_INLINE scoped_protection& operator=(scoped_protection&& other) noexcept;
+
+        /// \brief Restores the previous protection now instead of at scope exit.
+        NTW_INLINE ntw::status restore() noexcept;
+
+        /// \brief Keeps the new protection in place when going out of scope.
+        NTW_INLINE void release() noexcept;
+
+        /// \brief Returns the status of the protection change.
+        NTW_INLINE const ntw::status& status() const noexcept;
+
+        /// \brief Returns the protection that will be restored.
+        NTW_INLINE protection old() const noexcept;
+    };
+
+} // namespace ntw::vm
+
+#include "impl/protect.inl"
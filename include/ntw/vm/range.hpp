@@ -0,0 +1,45 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/common.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace ntw::vm {
+
+    /// \brief Range of virtual memory. Layout compatible with MEMORY_RANGE_ENTRY so
+    ///        spans of it can be passed to the APIs taking arrays of those directly.
+    struct range {
+        void*       address = nullptr;
+        std::size_t size    = 0;
+
+        /// \brief Returns the first address of the range.
+        NTW_INLINE std::uintptr_t begin() const noexcept
+        {
+            return reinterpret_cast<std::uintptr_t>(address);
+        }
+
+        /// \brief Returns one past the last address of the range.
+        NTW_INLINE std::uintptr_t end() const noexcept { return begin() + size; }
+    };
+
+    static_assert(sizeof(range) == sizeof(MEMORY_RANGE_ENTRY));
+    static_assert(offsetof(range, address) ==
+                  offsetof(MEMORY_RANGE_ENTRY, VirtualAddress));
+    static_assert(offsetof(range, size) == offsetof(MEMORY_RANGE_ENTRY, NumberOfBytes));
+
+} // namespace ntw::vm
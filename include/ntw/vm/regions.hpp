@@ -0,0 +1,137 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../info/memory.hpp"
+#include "../detail/unwrap.hpp"
+#include <iterator>
+
+namespace ntw::detail {
+
+    struct accept_all {
+        template<class T>
+        NTW_INLINE constexpr bool operator()(const T&) const noexcept
+        {
+            return true;
+        }
+    };
+
+} // namespace ntw::detail
+
+namespace ntw::vm {
+
+    /// \brief Lazy range over the memory regions of a process. Regions are queried
+    ///        one by one into a single memory::basic_info as the range is iterated.
+    ///
+    /// regions(process)
+    ///     .from(address)
+    ///     .until(address)
+    ///     .coalesced()
+    ///     .where([](const memory::basic_info& r) { return r.is_private(); });
+    ///
+    /// \note The range is single pass. Iteration stops at the first failed query, which
+    ///       is then available through status(). Reaching the end of address space is
+    ///       not a failure.
+    template<class Filter = ::ntw::detail::accept_all>
+    class region_range {
+        template<class>
+        friend class region_range;
+
+        void*              _process;
+        Filter             _filter;
+        std::uintptr_t     _address  = 0;
+        std::uintptr_t     _until    = ~std::uintptr_t{ 0 };
+        bool               _coalesce = false;
+        bool               _pending  = false;
+        memory::basic_info _current  = {};
+        memory::basic_info _next     = {};
+        ntw::status        _status   = STATUS_SUCCESS;
+
+        NTW_INLINE bool _query(memory::basic_info& info) noexcept;
+
+        NTW_INLINE bool _advance() noexcept;
+
+    public:
+        class iterator {
+            region_range* _range = nullptr;
+
+        public:
+            using difference_type   = std::ptrdiff_t;
+            using value_type        = memory::basic_info;
+            using pointer           = const memory::basic_info*;
+            using reference         = const memory::basic_info&;
+            using iterator_category = std::input_iterator_tag;
+
+            NTW_INLINE constexpr iterator() noexcept = default;
+
+            NTW_INLINE constexpr explicit iterator(region_range* range) noexcept
+                : _range(range)
+            {}
+
+            NTW_INLINE reference operator*() const noexcept { return _range->_current; }
+
+            NTW_INLINE pointer operator->() const noexcept { return &_range->_current; }
+
+            NTW_INLINE iterator& operator++() noexcept
+            {
+                if(!_range->_advance())
+                    _range = nullptr;
+                return *this;
+            }
+
+            NTW_INLINE void operator++(int) noexcept { ++*this; }
+
+            NTW_INLINE friend bool operator==(const iterator& lhs,
+                                              const iterator& rhs) noexcept
+            {
+                return lhs._range == rhs._range;
+            }
+        };
+
+        NTW_INLINE region_range(void* process, Filter filter) noexcept;
+
+        /// \brief Starts the walk at the region containing address.
+        NTW_INLINE region_range from(std::uintptr_t address) const noexcept;
+
+        /// \brief Stops the walk before the first region starting at or after address.
+        NTW_INLINE region_range until(std::uintptr_t address) const noexcept;
+
+        /// \brief Merges adjacent regions that have the same state, protection and type.
+        ///        The merged region keeps the allocation base of its first part.
+        NTW_INLINE region_range coalesced() const noexcept;
+
+        /// \brief Adds a predicate that regions must satisfy to be yielded.
+        /// \note Predicates see coalesced regions if coalescing is enabled.
+        template<class Predicate>
+        NTW_INLINE auto where(Predicate predicate) const noexcept;
+
+        /// \brief Queries the first region. Can be called only once.
+        NTW_INLINE iterator begin() noexcept;
+
+        NTW_INLINE iterator end() noexcept;
+
+        /// \brief Returns the status of failed query that stopped the iteration.
+        NTW_INLINE ntw::status status() const noexcept;
+    };
+
+    /// \brief Returns a lazy range over the memory regions of process.
+    template<class Process = void*>
+    NTW_INLINE region_range<>
+               regions(const Process& process = NtCurrentProcess()) noexcept;
+
+} // namespace ntw::vm
+
+#include "impl/regions.inl"
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "allocation.hpp"
+#include "operation.hpp"
+#include <atomic>
+#include <span>
+
+namespace ntw::vm {
+
+    /// \brief Single producer single consumer byte queue over a section that is mapped
+    ///        twice back to back. The byte after the end of the buffer is its first
+    ///        byte again, so both the readable and writable space is contiguous and
+    ///        records never have to be split at the wrap point.
+    ///
+    /// ring_buffer ring;
+    /// ring.create(0x100000);
+    /// // producer
+    /// if(auto area = ring.write_area(size); !area.empty()) {
+    ///     std::memcpy(area.data(), record, size);
+    ///     ring.produce(size);
+    /// }
+    /// // consumer
+    /// auto data = ring.read_area();
+    /// ring.consume(parse(data));
+    /// \note Only create and the destructor are not thread safe.
+    class ring_buffer {
+        // the indices only ever grow and are masked on access
+        struct alignas(64) producer_state {
+            std::atomic<std::size_t> head        = 0;
+            std::size_t              cached_tail = 0; // the last tail seen by producer
+        };
+
+        struct alignas(64) consumer_state {
+            std::atomic<std::size_t> tail        = 0;
+            std::size_t              cached_head = 0; // the last head seen by consumer
+        };
+
+        std::uint8_t* _data = nullptr;
+        std::size_t   _size = 0;
+
+        producer_state _producer;
+        consumer_state _consumer;
+
+        NTW_INLINE void _destroy() noexcept;
+
+    public:
+        /// \brief The granularity at which views can be mapped.
+        constexpr static std::size_t granularity = 0x10000;
+
+        NTW_INLINE ring_buffer() noexcept = default;
+
+        NTW_INLINE ~ring_buffer() noexcept;
+
+        ring_buffer(const ring_buffer&) = delete;
+        ring_buffer& operator=(const ring_buffer&) = delete;
+
+        /// \brief Creates the buffer, destroying the previous one.
+        /// \param size The capacity in bytes, rounded up to a power of 2 that is a
+        ///        multiple of granularity.
+        NTW_INLINE status create(std::size_t size) noexcept;
+
+        /// \brief Returns contiguous space for the producer to write into.
+        /// \param size The amount of bytes needed.
+        /// \returns Span of size bytes or an empty span if there is not enough space.
+        NTW_INLINE std::span<std::uint8_t> write_area(std::size_t size) noexcept;
+
+        /// \brief Publishes size bytes written into the write area to the consumer.
+        NTW_INLINE void produce(std::size_t size) noexcept;
+
+        /// \brief Copies size bytes into the buffer if all of them fit.
+        NTW_INLINE bool write(const void* data, std::size_t size) noexcept;
+
+        /// \brief Returns the contiguous data published for the consumer.
+        /// \note The producer is only consulted when no data is known to be available,
+        ///       so the span can be shorter than what has been published so far.
+        NTW_INLINE std::span<const std::uint8_t> read_area() noexcept;
+
+        /// \brief Returns size bytes of the read area back to the producer.
+        NTW_INLINE void consume(std::size_t size) noexcept;
+
+        /// \brief Copies size bytes out of the buffer if that many are available.
+        NTW_INLINE bool read(void* buffer, std::size_t size) noexcept;
+
+        /// \brief Returns the capacity of the buffer.
+        NTW_INLINE std::size_t capacity() const noexcept;
+
+        /// \brief Returns the amount of bytes published but not yet consumed.
+        /// \note The value can be out of date as soon as it is returned.
+        NTW_INLINE std::size_t size() const noexcept;
+
+        /// \brief Returns the first of the two views of the buffer.
+        NTW_INLINE std::uint8_t* data() const noexcept;
+    };
+
+} // namespace ntw::vm
+
+#include "impl/ring_buffer.inl"
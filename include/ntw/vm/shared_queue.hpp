@@ -0,0 +1,168 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../ob/event.hpp"
+#include "../ob/section.hpp"
+#include <atomic>
+#include <span>
+
+namespace ntw::vm {
+
+    /// \brief Multiple producer single consumer message queue in a section that can be
+    ///        mapped by several processes. Messages are written straight into the shared
+    ///        memory and read from it in place, the events are only signaled when the
+    ///        other side is blocked on an empty or a full queue.
+    ///
+    /// // collector
+    /// shared_queue queue;
+    /// queue.create(0x100000);
+    /// // duplicate queue.section(), queue.not_empty_event() and queue.not_full_event()
+    /// // into the uploader
+    /// queue.push(event, sizeof(event));
+    /// // uploader
+    /// shared_queue queue;
+    /// queue.attach(std::move(section), std::move(not_empty), std::move(not_full));
+    /// while(auto message = queue.wait_front()) {
+    ///     upload(*message);
+    ///     queue.pop();
+    /// }
+    /// \note Only create, attach and the destructor are not thread safe.
+    class shared_queue {
+        // lives at the start of the section, the indices only ever grow
+        struct shared_state {
+            std::uint64_t magic;
+            std::uint64_t capacity;
+
+            // bytes claimed by producers and published by them in order
+            alignas(64) std::atomic<std::uint64_t> reserved;
+            alignas(64) std::atomic<std::uint64_t> committed;
+            alignas(64) std::atomic<std::uint64_t> tail;
+
+            alignas(64) std::atomic<std::uint32_t> consumer_waiting;
+            std::atomic<std::uint32_t> producers_waiting;
+        };
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+        constexpr static std::uint64_t magic_value = 0x65756575'715F776E; // "nw_queue"
+
+        shared_state* _state = nullptr;
+        std::uint8_t* _data  = nullptr;
+        std::uint64_t _capacity = 0;
+
+        // the last tail seen by producers and the last commit seen by consumer
+        alignas(64) std::atomic<std::uint64_t> _cached_tail = 0;
+        alignas(64) std::uint64_t _cached_committed = 0;
+        std::uint64_t _front_size = 0; // size of the record returned by front
+
+        ob::section      _section;
+        ob::section_view _view;
+        ob::event        _not_empty;
+        ob::event        _not_full;
+
+        NTW_INLINE status _assign(ob::section      section,
+                                  ob::section_view view,
+                                  ob::event        not_empty,
+                                  ob::event        not_full) noexcept;
+
+        NTW_INLINE void _advance_tail(std::uint64_t tail) noexcept;
+
+        template<class Ready>
+        NTW_INLINE status _wait(std::atomic<std::uint32_t>& waiting,
+                                const ob::event&            event,
+                                Ready                       ready) noexcept;
+
+    public:
+        /// \brief Space claimed by try_reserve that is published by commit.
+        struct reservation {
+            std::span<std::uint8_t> data;
+            std::uint64_t           begin = 0;
+            std::uint64_t           end   = 0;
+
+            /// \brief Checks whether the space was reserved.
+            NTW_INLINE explicit operator bool() const noexcept { return begin != end; }
+        };
+
+        NTW_INLINE shared_queue() noexcept = default;
+
+        shared_queue(const shared_queue&) = delete;
+        shared_queue& operator=(const shared_queue&) = delete;
+
+        /// \brief Creates the section and events of a new queue.
+        /// \param capacity The capacity in bytes, rounded up to a power of 2 of at
+        ///        least a page.
+        NTW_INLINE status create(std::size_t capacity) noexcept;
+
+        /// \brief Uses the objects of a queue created by another process.
+        /// \param section The section needs map read and map write access.
+        /// \param not_empty The events need modify state and synchronize access.
+        NTW_INLINE status attach(ob::section section,
+                                 ob::event   not_empty,
+                                 ob::event   not_full) noexcept;
+
+        /// \brief Returns the largest message that is guaranteed to fit into the queue.
+        NTW_INLINE std::size_t max_message_size() const noexcept;
+
+        /// \brief Claims space for a message of given size.
+        /// \returns Empty reservation if there is not enough space or the message is
+        ///          larger than max_message_size.
+        NTW_INLINE reservation try_reserve(std::size_t size) noexcept;
+
+        /// \brief Publishes a reserved message to the consumer.
+        /// \note Producers publish in the order they reserved in, so commit waits for
+        ///       producers that reserved earlier to commit first.
+        NTW_INLINE void commit(const reservation& r) noexcept;
+
+        /// \brief Copies the message into the queue if there is enough space.
+        NTW_INLINE bool try_push(const void* data, std::size_t size) noexcept;
+
+        /// \brief Copies the message into the queue, waiting for space if needed.
+        /// \returns STATUS_INVALID_PARAMETER if the message is larger than
+        ///          max_message_size.
+        NTW_INLINE status push(const void* data, std::size_t size) noexcept;
+
+        /// \brief Returns the oldest message without removing it.
+        /// \returns STATUS_NO_MORE_ENTRIES if the queue is empty or STATUS_DATA_ERROR if
+        ///          the shared memory was corrupted.
+        NTW_INLINE result<std::span<const std::uint8_t>> front() noexcept;
+
+        /// \brief Same as front, but waits for a message if the queue is empty.
+        NTW_INLINE result<std::span<const std::uint8_t>> wait_front() noexcept;
+
+        /// \brief Removes the oldest message returning its space to producers.
+        NTW_INLINE void pop() noexcept;
+
+        /// \brief Returns the capacity of the queue in bytes.
+        NTW_INLINE std::size_t capacity() const noexcept;
+
+        /// \brief Returns the amount of bytes published but not yet popped.
+        /// \note The value can be out of date as soon as it is returned.
+        NTW_INLINE std::size_t size() const noexcept;
+
+        /// \brief Returns the section holding the queue.
+        NTW_INLINE const ob::section& section() const noexcept;
+
+        /// \brief Returns the event signaled for a consumer waiting for messages.
+        NTW_INLINE const ob::event& not_empty_event() const noexcept;
+
+        /// \brief Returns the event signaled for producers waiting for space.
+        NTW_INLINE const ob::event& not_full_event() const noexcept;
+    };
+
+} // namespace ntw::vm
+
+#include "impl/shared_queue.inl"
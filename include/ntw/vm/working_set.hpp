@@ -0,0 +1,99 @@
+/*
+ * Copyright 2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../detail/growable_buffer.hpp"
+#include "../detail/unwrap.hpp"
+#include "../info/memory.hpp"
+#include <span>
+
+namespace ntw::vm {
+
+    /// \brief Working set state of many pages queried with a single syscall and packed
+    ///        into bitmaps in which bit i of word i / 64 belongs to page i.
+    ///
+    /// residency_map map;
+    /// map.query(index_base, index_size);
+    /// auto resident = map.resident_count();
+    /// \note The map keeps its buffers between queries so it should be reused.
+    class residency_map {
+        ntw::detail::growable_buffer _entries;
+        ntw::detail::growable_buffer _bits; // resident, shared and locked bitmaps
+        ntw::detail::growable_buffer _nodes;
+        std::size_t                  _count = 0;
+
+        NTW_INLINE std::size_t _words() const noexcept;
+
+        NTW_INLINE std::span<const std::uint64_t> _bitmap(std::size_t i) const noexcept;
+
+        NTW_INLINE bool _test(std::size_t bitmap, std::size_t page) const noexcept;
+
+        template<class Process>
+        NTW_INLINE status _query(const Process& process) noexcept;
+
+    public:
+        constexpr static std::size_t page_size = 0x1000;
+
+        NTW_INLINE residency_map() noexcept = default;
+
+        /// \brief Queries the pages containing the given addresses.
+        template<class Process = void*>
+        NTW_INLINE status query(std::span<const std::uintptr_t> addresses,
+                                const Process& process = NtCurrentProcess()) noexcept;
+
+        /// \brief Queries every page of [address, address + size).
+        template<class Address, class Process = void*>
+        NTW_INLINE status query(Address        address,
+                                std::size_t    size,
+                                const Process& process = NtCurrentProcess()) noexcept;
+
+        /// \brief Returns the amount of pages queried.
+        NTW_INLINE std::size_t size() const noexcept;
+
+        /// \brief Returns whether page i is resident in the working set.
+        NTW_INLINE bool resident(std::size_t i) const noexcept;
+
+        /// \brief Returns whether page i is shareable.
+        NTW_INLINE bool shared(std::size_t i) const noexcept;
+
+        /// \brief Returns whether page i is locked in memory.
+        NTW_INLINE bool locked(std::size_t i) const noexcept;
+
+        /// \brief Returns the NUMA node of page i, valid only if it is resident.
+        NTW_INLINE std::uint8_t node(std::size_t i) const noexcept;
+
+        /// \brief Returns the bitmap of resident pages.
+        NTW_INLINE std::span<const std::uint64_t> resident_bits() const noexcept;
+
+        /// \brief Returns the bitmap of shareable pages.
+        NTW_INLINE std::span<const std::uint64_t> shared_bits() const noexcept;
+
+        /// \brief Returns the bitmap of locked pages.
+        NTW_INLINE std::span<const std::uint64_t> locked_bits() const noexcept;
+
+        /// \brief Returns the NUMA node of every page, 0 for those not resident.
+        NTW_INLINE std::span<const std::uint8_t> nodes() const noexcept;
+
+        /// \brief Returns the amount of resident pages.
+        NTW_INLINE std::size_t resident_count() const noexcept;
+
+        /// \brief Returns the unpacked result of the last query.
+        NTW_INLINE std::span<const memory::working_set_ex_info> entries() const noexcept;
+    };
+
+} // namespace ntw::vm
+
+#include "impl/working_set.inl"
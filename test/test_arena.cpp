@@ -0,0 +1,247 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace fake {
+
+    using ::NtAllocateVirtualMemoryEx;
+    using ::NtUnmapViewOfSection;
+
+    // reserved ranges backed by real memory with the state of every page
+    struct block {
+        std::vector<std::uint8_t> storage; // over-allocated so data can be page aligned
+        std::uint8_t*             data;
+        std::size_t               size;
+        std::vector<bool>         committed;
+    };
+
+    std::vector<block> blocks;
+    std::size_t        commits = 0, decommits = 0, resets = 0;
+
+    block* find(void* address)
+    {
+        const auto a = static_cast<std::uint8_t*>(address);
+        for(auto& b : blocks)
+            if(a >= b.data && a < b.data + b.size)
+                return &b;
+        return nullptr;
+    }
+
+    bool committed(void* address)
+    {
+        const auto b = find(address);
+        if(!b)
+            return false;
+        return b->committed[(static_cast<std::uint8_t*>(address) - b->data) / 0x1000];
+    }
+
+    NTSTATUS set_state(void* address, SIZE_T size, bool state)
+    {
+        const auto b = find(address);
+        if(!b || static_cast<std::uint8_t*>(address) + size > b->data + b->size)
+            return STATUS_CONFLICTING_ADDRESSES;
+
+        const auto first = (static_cast<std::uint8_t*>(address) - b->data) / 0x1000;
+        for(auto i = first; i < first + (size + 0xFFF) / 0x1000; ++i)
+            b->committed[i] = state;
+        return STATUS_SUCCESS;
+    }
+
+    NTSTATUS NTAPI NtAllocateVirtualMemory(
+        HANDLE, PVOID* address, ULONG_PTR, PSIZE_T size, ULONG type, ULONG)
+    {
+        if(!*address) {
+            const auto rounded = (*size + 0xFFF) & ~SIZE_T{ 0xFFF };
+
+            std::vector<std::uint8_t> storage(rounded + 0x1000);
+            void*                     data  = storage.data();
+            std::size_t               space = storage.size();
+            std::align(0x1000, rounded, data, space);
+
+            blocks.push_back({ std::move(storage),
+                               static_cast<std::uint8_t*>(data),
+                               rounded,
+                               std::vector<bool>(rounded / 0x1000) });
+            *address = data;
+            *size    = rounded;
+            return (type & MEM_COMMIT) ? set_state(data, rounded, true) : STATUS_SUCCESS;
+        }
+
+        if(type & MEM_RESET) {
+            ++resets;
+            for(SIZE_T i = 0; i < *size; i += 0x1000)
+                if(!committed(static_cast<std::uint8_t*>(*address) + i))
+                    return STATUS_CONFLICTING_ADDRESSES;
+            return STATUS_SUCCESS;
+        }
+
+        ++commits;
+        return set_state(*address, *size, true);
+    }
+
+    NTSTATUS NTAPI NtFreeVirtualMemory(HANDLE, PVOID* address, PSIZE_T size, ULONG type)
+    {
+        if(type == MEM_DECOMMIT) {
+            ++decommits;
+            return set_state(*address, *size, false);
+        }
+
+        for(auto it = blocks.begin(); it != blocks.end(); ++it) {
+            if(it->data == *address) {
+                blocks.erase(it);
+                return STATUS_SUCCESS;
+            }
+        }
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    void reset_counters() { commits = decommits = resets = 0; }
+
+} // namespace fake
+
+#include <ntw/vm/arena.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+std::uint8_t* allocate(ntw::vm::arena& a, std::size_t size, std::size_t alignment = 16)
+{
+    const auto res = a.allocate(size, alignment);
+    REQUIRE(res.success());
+    REQUIRE(reinterpret_cast<std::uintptr_t>(*res) % alignment == 0);
+
+    // the memory must be committed and writable
+    const auto p = static_cast<std::uint8_t*>(*res);
+    for(std::size_t i = 0; i < size; i += 0x1000)
+        REQUIRE(fake::committed(p + i));
+    if(size) {
+        REQUIRE(fake::committed(p + size - 1));
+        std::memset(p, 0xAB, size);
+    }
+    return p;
+}
+
+TEST_CASE("arena commits in chunks as allocations advance")
+{
+    fake::reset_counters();
+
+    ntw::vm::arena a;
+    a.chunk_size(0x4000);
+    REQUIRE(a.reserve(0x100000).success());
+    REQUIRE(a.reserved() == 0x100000);
+    REQUIRE(a.committed() == 0);
+
+    const auto first = allocate(a, 100);
+    REQUIRE(first == a.data());
+    REQUIRE(a.committed() == 0x4000);
+    REQUIRE(fake::commits == 1);
+
+    // fits into the committed chunk
+    const auto second = allocate(a, 200, 64);
+    REQUIRE(second == first + 128);
+    REQUIRE(fake::commits == 1);
+
+    // spans the end of the chunk
+    allocate(a, 0x5000);
+    REQUIRE(a.committed() == 0x8000);
+    REQUIRE(fake::commits == 2);
+
+    REQUIRE(a.allocate(0x100000) == STATUS_NO_MEMORY);
+    REQUIRE(a.allocate(~std::size_t{ 0 } - 8) == STATUS_NO_MEMORY);
+}
+
+TEST_CASE("arena rewind, reset and decommit")
+{
+    fake::reset_counters();
+
+    ntw::vm::arena a;
+    a.chunk_size(0x4000);
+    REQUIRE(a.reserve(0x100000).success());
+
+    allocate(a, 0x9000);
+    REQUIRE(fake::commits == 1);
+
+    // rewound memory is reused without committing again
+    a.rewind();
+    REQUIRE(a.used() == 0);
+    REQUIRE(allocate(a, 0x9000) == a.data());
+    REQUIRE(fake::commits == 1);
+
+    REQUIRE(a.reset().success());
+    REQUIRE(fake::resets == 1);
+    REQUIRE(a.committed() == 0x9000);
+    REQUIRE(fake::committed(a.data()));
+    allocate(a, 0x9000);
+    REQUIRE(fake::commits == 1);
+
+    REQUIRE(a.decommit().success());
+    REQUIRE(a.committed() == 0);
+    REQUIRE_FALSE(fake::committed(a.data()));
+    allocate(a, 0x10);
+    REQUIRE(fake::commits == 2);
+}
+
+TEST_CASE("arena with guard pages")
+{
+    fake::reset_counters();
+
+    ntw::vm::arena a;
+    a.chunk_size(0x2000).guard_pages();
+    REQUIRE(a.reserve(0x40000).success());
+
+    const auto base  = static_cast<std::uint8_t*>(a.data());
+    const auto first = allocate(a, 0x1800);
+    REQUIRE(first == base);
+
+    // does not fit into the rest of the chunk so it moves past the guard page
+    const auto second = allocate(a, 0x1000);
+    REQUIRE(second == base + 0x3000);
+    REQUIRE_FALSE(fake::committed(base + 0x2000));
+    REQUIRE_FALSE(fake::committed(base + 0x5000));
+
+    // larger than a chunk
+    const auto third = allocate(a, 0x3800, 0x4000);
+    REQUIRE(third >= base + 0x6000);
+    REQUIRE(third < base + 0xA000);
+    REQUIRE(fake::commits == 3);
+    REQUIRE(fake::committed(base + 0xC000));
+    REQUIRE_FALSE(fake::committed(base + 0xD000));
+
+    // the same sequence reuses the committed chunks
+    a.rewind();
+    REQUIRE(allocate(a, 0x1800) == first);
+    REQUIRE(allocate(a, 0x1000) == second);
+    REQUIRE(allocate(a, 0x3800, 0x4000) == third);
+    REQUIRE(fake::commits == 3);
+
+    REQUIRE(a.reset().success());
+    REQUIRE(fake::resets == 3);
+
+    // a different sequence replaces the chunks that no longer fit
+    allocate(a, 0x1800);
+    const auto large = allocate(a, 0x2800);
+    REQUIRE(large == base + 0x3000);
+    REQUIRE(fake::decommits == 1);
+    REQUIRE_FALSE(fake::committed(base + 0x6000));
+    REQUIRE(a.committed() == 0x6000);
+
+    REQUIRE(a.allocate(0x40000) == STATUS_NO_MEMORY);
+}
+
+TEST_CASE("arena releases its range")
+{
+    const auto blocks = fake::blocks.size();
+    {
+        ntw::vm::arena a;
+        REQUIRE(a.reserve(0x10000).success());
+        allocate(a, 0x100);
+
+        ntw::vm::arena b = std::move(a);
+        REQUIRE(a.data() == nullptr);
+        REQUIRE(b.reserved() == 0x10000);
+        REQUIRE(fake::blocks.size() > blocks);
+    }
+    REQUIRE(fake::blocks.size() == blocks);
+}
@@ -0,0 +1,295 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <memory>
+#include <vector>
+
+namespace fake {
+
+    using ::NtCreateFile;
+    using ::NtDelayExecution;
+    using ::NtDeleteFile;
+    using ::NtFlushBuffersFile;
+    using ::NtMakePermanentObject;
+    using ::NtMakeTemporaryObject;
+    using ::NtOpenEvent;
+    using ::NtQueryInformationFile;
+    using ::NtResetEvent;
+
+    struct event {
+        EVENT_TYPE type;
+        bool       signaled;
+    };
+
+    // requests that have been issued but not yet completed by the test
+    struct request {
+        HANDLE           event;
+        PIO_APC_ROUTINE  apc;
+        PVOID            context;
+        PIO_STATUS_BLOCK status_block;
+        std::uint8_t*    buffer;
+        ULONG            size;
+        LONGLONG         offset;
+        bool             write;
+    };
+
+    constexpr LONGLONG file_size = 0x100000;
+
+    std::vector<request> requests;
+
+    NTSTATUS NTAPI NtCreateEvent(
+        PHANDLE handle, ACCESS_MASK, POBJECT_ATTRIBUTES, EVENT_TYPE type, BOOLEAN)
+    {
+        *handle = new event{ type, false };
+        return STATUS_SUCCESS;
+    }
+
+    NTSTATUS NTAPI NtSetEvent(HANDLE handle, PLONG)
+    {
+        static_cast<event*>(handle)->signaled = true;
+        return STATUS_SUCCESS;
+    }
+
+    NTSTATUS NTAPI NtWaitForSingleObject(HANDLE handle, BOOLEAN, PLARGE_INTEGER timeout)
+    {
+        const auto e = static_cast<event*>(handle);
+        if(!e)
+            return STATUS_INVALID_HANDLE;
+        if(e->signaled) {
+            if(e->type == SynchronizationEvent)
+                e->signaled = false;
+            return STATUS_SUCCESS;
+        }
+        // nothing else could ever complete the request
+        return timeout ? STATUS_TIMEOUT : STATUS_POSSIBLE_DEADLOCK;
+    }
+
+    NTSTATUS NTAPI NtClose(HANDLE handle)
+    {
+        delete static_cast<event*>(handle);
+        return STATUS_SUCCESS;
+    }
+
+    NTSTATUS issue(HANDLE           file,
+                   HANDLE           event,
+                   PIO_APC_ROUTINE  apc,
+                   PVOID            context,
+                   PIO_STATUS_BLOCK status_block,
+                   PVOID            buffer,
+                   ULONG            size,
+                   PLARGE_INTEGER   offset,
+                   bool             write)
+    {
+        if(file != reinterpret_cast<HANDLE>(0x44) || !offset)
+            return STATUS_INVALID_PARAMETER;
+        // fails without ever completing the request
+        if(offset->QuadPart >= file_size)
+            return STATUS_END_OF_FILE;
+
+        requests.push_back({ event,
+                             apc,
+                             context,
+                             status_block,
+                             static_cast<std::uint8_t*>(buffer),
+                             size,
+                             offset->QuadPart,
+                             write });
+        return STATUS_PENDING;
+    }
+
+    NTSTATUS NTAPI NtReadFile(HANDLE           file,
+                              HANDLE           event,
+                              PIO_APC_ROUTINE  apc,
+                              PVOID            context,
+                              PIO_STATUS_BLOCK status_block,
+                              PVOID            buffer,
+                              ULONG            size,
+                              PLARGE_INTEGER   offset,
+                              PULONG)
+    {
+        return issue(
+            file, event, apc, context, status_block, buffer, size, offset, false);
+    }
+
+    NTSTATUS NTAPI NtWriteFile(HANDLE           file,
+                               HANDLE           event,
+                               PIO_APC_ROUTINE  apc,
+                               PVOID            context,
+                               PIO_STATUS_BLOCK status_block,
+                               PVOID            buffer,
+                               ULONG            size,
+                               PLARGE_INTEGER   offset,
+                               PULONG)
+    {
+        return issue(
+            file, event, apc, context, status_block, buffer, size, offset, true);
+    }
+
+    // does what the I/O manager does once the driver completes the request
+    void complete(std::size_t i, NTSTATUS status)
+    {
+        const auto r = requests[i];
+        requests.erase(requests.begin() + i);
+
+        ULONG transferred = 0;
+        if(status == STATUS_SUCCESS && !r.write) {
+            for(ULONG j = 0; j < r.size; ++j)
+                r.buffer[j] = static_cast<std::uint8_t>((r.offset + j) / 3);
+            transferred = r.size;
+        }
+        else if(status == STATUS_SUCCESS)
+            transferred = r.size;
+
+        r.status_block->Information = transferred;
+        r.status_block->Status      = status;
+        if(r.event)
+            static_cast<event*>(r.event)->signaled = true;
+        if(r.apc)
+            r.apc(r.context, r.status_block, 0);
+    }
+
+    NTSTATUS NTAPI NtCancelIoFileEx(HANDLE           file,
+                                    PIO_STATUS_BLOCK status_block,
+                                    PIO_STATUS_BLOCK)
+    {
+        if(file != reinterpret_cast<HANDLE>(0x44))
+            return STATUS_INVALID_HANDLE;
+
+        bool found = false;
+        for(std::size_t i = requests.size(); i-- > 0;) {
+            if(!status_block || requests[i].status_block == status_block) {
+                complete(i, STATUS_CANCELLED);
+                found = true;
+            }
+        }
+        return found ? STATUS_SUCCESS : STATUS_NOT_FOUND;
+    }
+
+} // namespace fake
+
+#include <ntw/io/async_file.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+ntw::io::async_file_ref test_file()
+{
+    return ntw::io::async_file_ref{ reinterpret_cast<void*>(0x44) };
+}
+
+std::unique_ptr<ntw::io::operation> make_operation()
+{
+    auto e = ntw::ob::event::create(NotificationEvent);
+    REQUIRE(e.success());
+    return std::make_unique<ntw::io::operation>(std::move(*e));
+}
+
+TEST_CASE("many reads are in flight at once")
+{
+    const auto file = test_file();
+
+    constexpr std::size_t depth = 64, size = 0x1000;
+
+    std::vector<std::unique_ptr<ntw::io::operation>> ops;
+    std::vector<std::uint8_t>                        buffer(depth * size);
+    for(std::size_t i = 0; i < depth; ++i) {
+        ops.push_back(make_operation());
+        const auto offset = i * size;
+        REQUIRE(file.read_async({ buffer.data() + offset, size },
+                                static_cast<std::int64_t>(offset),
+                                *ops.back()) == STATUS_PENDING);
+    }
+    REQUIRE(fake::requests.size() == depth);
+
+    for(auto& op : ops) {
+        REQUIRE(op->pending());
+        REQUIRE(op->wait_for(ntw::duration{ 0 }) == STATUS_TIMEOUT);
+    }
+
+    // completed out of order
+    for(std::size_t i = depth; i-- > 0;) {
+        fake::complete(i, STATUS_SUCCESS);
+        REQUIRE_FALSE(ops[i]->pending());
+        REQUIRE(ops[i]->wait() == STATUS_SUCCESS);
+        REQUIRE(ops[i]->transferred() == size);
+        if(i > 0)
+            REQUIRE(ops[i - 1]->pending());
+    }
+
+    for(std::size_t i = 0; i < buffer.size(); ++i)
+        REQUIRE(buffer[i] == static_cast<std::uint8_t>(i / 3));
+
+    // notification events stay signaled
+    REQUIRE(ops[0]->wait() == STATUS_SUCCESS);
+}
+
+TEST_CASE("callbacks are called on completion")
+{
+    const auto file = test_file();
+
+    std::size_t calls  = 0;
+    const auto  notify = [](ntw::io::operation& op) noexcept {
+        ++*static_cast<std::size_t*>(op.context());
+    };
+    ntw::io::operation first(notify, &calls), second(notify, &calls);
+
+    const std::uint8_t data[0x200] = {};
+    REQUIRE(file.write_async(data, 0x1000, first) == STATUS_PENDING);
+    REQUIRE(file.write_async(data, 0x2000, second) == STATUS_PENDING);
+    REQUIRE(fake::requests[0].write);
+    REQUIRE(fake::requests[0].event == nullptr);
+    REQUIRE(fake::requests[0].context == &first);
+
+    fake::complete(1, STATUS_SUCCESS);
+    REQUIRE(calls == 1);
+    REQUIRE(second.status() == STATUS_SUCCESS);
+    REQUIRE(second.transferred() == sizeof(data));
+    REQUIRE(first.pending());
+
+    // reused once complete
+    REQUIRE(file.write_async(data, 0x3000, second) == STATUS_PENDING);
+    REQUIRE(second.pending());
+    REQUIRE(second.transferred() == 0);
+
+    fake::complete(0, STATUS_SUCCESS);
+    fake::complete(0, STATUS_DISK_FULL);
+    REQUIRE(calls == 3);
+    REQUIRE(first.status() == STATUS_SUCCESS);
+    REQUIRE(second.status() == STATUS_DISK_FULL);
+}
+
+TEST_CASE("requests that fail right away complete the operation")
+{
+    const auto file = test_file();
+    const auto op   = make_operation();
+
+    std::uint8_t buffer[0x100];
+    REQUIRE(file.read_async(buffer, fake::file_size, *op) == STATUS_END_OF_FILE);
+    REQUIRE(fake::requests.empty());
+    REQUIRE_FALSE(op->pending());
+    REQUIRE(op->status() == STATUS_END_OF_FILE);
+    REQUIRE(op->wait() == STATUS_END_OF_FILE);
+    REQUIRE(op->transferred() == 0);
+}
+
+TEST_CASE("requests are cancelled")
+{
+    const auto file = test_file();
+
+    std::uint8_t buffer[3][0x100];
+    const auto   first = make_operation(), second = make_operation(),
+               third = make_operation();
+    REQUIRE(file.read_async(buffer[0], 0, *first) == STATUS_PENDING);
+    REQUIRE(file.read_async(buffer[1], 0x100, *second) == STATUS_PENDING);
+    REQUIRE(file.read_async(buffer[2], 0x200, *third) == STATUS_PENDING);
+
+    REQUIRE(file.cancel(*second).success());
+    REQUIRE(second->wait() == STATUS_CANCELLED);
+    REQUIRE(first->pending());
+    REQUIRE(third->pending());
+    REQUIRE(file.cancel(*second) == STATUS_NOT_FOUND);
+
+    REQUIRE(file.cancel().success());
+    REQUIRE(first->wait() == STATUS_CANCELLED);
+    REQUIRE(third->wait() == STATUS_CANCELLED);
+    REQUIRE(fake::requests.empty());
+}
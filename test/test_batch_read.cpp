@@ -0,0 +1,139 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <vector>
+
+namespace fake {
+
+    using ::NtAllocateVirtualMemory;
+    using ::NtAllocateVirtualMemoryEx;
+    using ::NtClose;
+    using ::NtFreeVirtualMemory;
+    using ::NtUnmapViewOfSection;
+
+    // 16 pages of memory at 0x10000 where every byte holds the low bits of its address
+    constexpr std::uintptr_t base       = 0x10000;
+    constexpr std::size_t    size       = 0x10000;
+    std::uintptr_t           unreadable = 0;
+    std::size_t              reads      = 0;
+
+    std::uint8_t byte_at(std::uintptr_t address)
+    {
+        return static_cast<std::uint8_t>(address ^ (address >> 8));
+    }
+
+    NTSTATUS NTAPI
+    NtReadVirtualMemory(HANDLE, PVOID address, PVOID buffer, SIZE_T length, PSIZE_T read)
+    {
+        ++reads;
+        const auto a   = reinterpret_cast<std::uintptr_t>(address);
+        const auto out = static_cast<std::uint8_t*>(buffer);
+
+        SIZE_T copied = 0;
+        for(; copied < length; ++copied) {
+            const auto current = a + copied;
+            if(current < base || current >= base + size ||
+               (current & ~std::uintptr_t{ 0xFFF }) == unreadable)
+                break;
+            out[copied] = byte_at(current);
+        }
+
+        // the real syscall reports partial copies in coarse chunks
+        if(read)
+            *read = copied == length ? copied : copied & ~SIZE_T{ 0x1FFF };
+        if(copied == length)
+            return STATUS_SUCCESS;
+        return copied ? STATUS_PARTIAL_COPY : STATUS_ACCESS_VIOLATION;
+    }
+
+} // namespace fake
+
+#include <ntw/vm/batch_read.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+bool holds_memory(const ntw::vm::read_request& request)
+{
+    const auto bytes = static_cast<const std::uint8_t*>(request.buffer);
+    for(std::size_t i = 0; i < request.size; ++i)
+        if(bytes[i] != fake::byte_at(request.address + i))
+            return false;
+    return true;
+}
+
+TEST_CASE("batch_reader merges requests on touching pages")
+{
+    fake::unreadable = 0;
+    fake::reads      = 0;
+
+    // pointer sized reads spread over 0x10000 - 0x13000 and 0x18000 - 0x19000
+    std::vector<std::uint64_t>         values(1000);
+    std::vector<ntw::vm::read_request> requests;
+    for(std::size_t i = 0; i < values.size(); ++i) {
+        const auto address = i % 2 ? 0x10000 + (i * 37) % 0x2FF8 : 0x18000 + i * 4;
+        requests.push_back({ address, &values[i], sizeof(values[i]) });
+    }
+
+    ntw::vm::batch_reader reader;
+    REQUIRE(reader.read(std::span(requests)).success());
+    REQUIRE(fake::reads == 2);
+
+    for(const auto& request : requests) {
+        CHECK(request.status.success());
+        CHECK(holds_memory(request));
+    }
+}
+
+TEST_CASE("batch_reader reports unreadable pages per request")
+{
+    fake::unreadable = 0x15000;
+    fake::reads      = 0;
+
+    std::uint8_t before[16], straddling[32], inside[8], after[64], none[1];
+
+    ntw::vm::read_request requests[] = {
+        { 0x16010, after, sizeof(after) },
+        { 0x14FF0, straddling, sizeof(straddling) },
+        { 0x15800, inside, sizeof(inside) },
+        { 0x12FF8, before, sizeof(before) },
+        { 0x20000, none, sizeof(none) },
+        { 0x15000, nullptr, 0 },
+    };
+
+    ntw::vm::batch_reader reader;
+    REQUIRE(reader.read(std::span(requests)) == STATUS_PARTIAL_COPY);
+
+    // 0x12000 - 0x17000 reports 0x2000 bytes so 0x14000 is retried alone, then the
+    // rest of run fails and 0x15000 is retried before reading 0x16000. The request
+    // outside of memory is read and retried once.
+    REQUIRE(fake::reads == 7);
+
+    REQUIRE(requests[0].status.success());
+    REQUIRE(holds_memory(requests[0]));
+    REQUIRE(requests[1].status == STATUS_ACCESS_VIOLATION);
+    REQUIRE(requests[2].status == STATUS_ACCESS_VIOLATION);
+    REQUIRE(requests[3].status.success());
+    REQUIRE(holds_memory(requests[3]));
+    REQUIRE(requests[4].status == STATUS_ACCESS_VIOLATION);
+    REQUIRE(requests[5].status.success());
+}
+
+TEST_CASE("batch_reader reads large requests directly")
+{
+    fake::unreadable = 0;
+    fake::reads      = 0;
+
+    std::vector<std::uint8_t> large(ntw::vm::batch_reader::direct_read_size);
+    std::uint32_t             small;
+
+    ntw::vm::read_request requests[] = {
+        { fake::base, large.data(), large.size() },
+        { fake::base + 0x100, &small, sizeof(small) },
+    };
+
+    ntw::vm::batch_reader reader;
+    REQUIRE(reader.read(std::span(requests)).success());
+    REQUIRE(fake::reads == 2);
+    REQUIRE(holds_memory(requests[0]));
+    REQUIRE(holds_memory(requests[1]));
+}
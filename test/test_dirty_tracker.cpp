@@ -0,0 +1,97 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <set>
+
+namespace fake {
+
+    using ::NtAllocateVirtualMemory;
+    using ::NtAllocateVirtualMemoryEx;
+    using ::NtFreeVirtualMemory;
+    using ::NtUnmapViewOfSection;
+
+    std::uintptr_t           base = 0x100000;
+    std::set<std::uintptr_t> dirty;
+
+    NTSTATUS NTAPI NtGetWriteWatch(HANDLE,
+                                   ULONG      flags,
+                                   PVOID      address,
+                                   SIZE_T     size,
+                                   PVOID*     addresses,
+                                   ULONG_PTR* count,
+                                   PULONG     granularity)
+    {
+        const auto begin = reinterpret_cast<std::uintptr_t>(address);
+        if(begin != base)
+            return STATUS_INVALID_PARAMETER;
+
+        ULONG_PTR written = 0;
+        for(const auto page : dirty) {
+            if(page < begin || page >= begin + size)
+                continue;
+            if(written == *count)
+                return STATUS_BUFFER_TOO_SMALL;
+            addresses[written++] = reinterpret_cast<void*>(page);
+        }
+
+        if(flags & WRITE_WATCH_FLAG_RESET)
+            dirty.clear();
+
+        *count       = written;
+        *granularity = 0x1000;
+        return STATUS_SUCCESS;
+    }
+
+    NTSTATUS NTAPI NtResetWriteWatch(HANDLE, PVOID, SIZE_T)
+    {
+        dirty.clear();
+        return STATUS_SUCCESS;
+    }
+
+} // namespace fake
+
+#include <ntw/vm/dirty_tracker.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+TEST_CASE("dirty_tracker lists written pages")
+{
+    ntw::vm::dirty_tracker tracker(fake::base, 0x80000);
+    REQUIRE(tracker.page_count() == 0x80);
+
+    fake::dirty = { fake::base, fake::base + 0x5000, fake::base + 0x7F000 };
+
+    // peeking leaves the pages dirty
+    auto pages = tracker.dirty_pages(false);
+    REQUIRE(pages.success());
+    REQUIRE(pages->size() == 3);
+    REQUIRE((*pages)[1] == reinterpret_cast<void*>(fake::base + 0x5000));
+
+    pages = tracker.dirty_pages();
+    REQUIRE(pages->size() == 3);
+    REQUIRE(tracker.dirty_pages()->empty());
+
+    fake::dirty = { fake::base + 0x1000 };
+    REQUIRE(tracker.reset().success());
+    REQUIRE(tracker.dirty_pages()->empty());
+}
+
+TEST_CASE("dirty_tracker bitmap")
+{
+    ntw::vm::dirty_tracker tracker(fake::base, 0x81000);
+
+    fake::dirty = { fake::base, fake::base + 0x3F000, fake::base + 0x40000,
+                    fake::base + 0x80000 };
+
+    const auto bitmap = tracker.dirty_bitmap();
+    REQUIRE(bitmap.success());
+    REQUIRE(bitmap->size() == 3);
+    REQUIRE((*bitmap)[0] == ((std::uint64_t{ 1 } << 63) | 1));
+    REQUIRE((*bitmap)[1] == 1);
+    REQUIRE((*bitmap)[2] == 1);
+
+    // words left over from the previous call are cleared
+    fake::dirty = { fake::base + 0x2000 };
+    REQUIRE(tracker.dirty_bitmap()->front() == 4);
+    REQUIRE((*tracker.dirty_bitmap())[1] == 0);
+}
@@ -0,0 +1,53 @@
+#include <ntw/sys/handles.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+#include <vector>
+
+#pragma comment(lib, "ntdll.lib")
+
+TEST_CASE("handle_snapshot lists own handles")
+{
+    ntw::sys::handle_snapshot snapshot;
+    REQUIRE(snapshot.refresh().success());
+    REQUIRE(!snapshot.entries().empty());
+
+    const auto pid   = reinterpret_cast<std::uintptr_t>(NtCurrentProcessId());
+    bool       found = false;
+    for(const auto& h : snapshot.entries())
+        found |= h.process_id == pid;
+    REQUIRE(found);
+}
+
+TEST_CASE("handle_groups groups by process and type")
+{
+    std::vector<ntw::sys::handle_entry> entries(1000);
+    for(std::size_t i = 0; i < entries.size(); ++i) {
+        entries[i].process_id        = (i % 7) * 4 + 4;
+        entries[i].object_type_index = static_cast<std::uint16_t>(i % 3 + 2);
+        entries[i].value             = i;
+    }
+
+    ntw::sys::handle_groups groups;
+    REQUIRE(groups.assign(entries).success());
+
+    for(std::uintptr_t p = 0; p < 7; ++p) {
+        const auto indices = groups.by_process(p * 4 + 4);
+        REQUIRE(indices.size() == (1000 - p + 6) / 7);
+        for(std::size_t i = 0; i < indices.size(); ++i)
+            REQUIRE(indices[i] == p + i * 7);
+    }
+
+    REQUIRE(groups.by_process(0).empty());
+    REQUIRE(groups.by_process(0x10000).empty());
+    REQUIRE(groups.by_process(5).empty());
+    REQUIRE(groups.by_type(2).size() == 334);
+    REQUIRE(groups.by_type(4).size() == 333);
+    REQUIRE(groups.by_type(5).empty());
+
+    // regrouping a smaller set reuses the storage
+    entries.resize(10);
+    REQUIRE(groups.assign(entries).success());
+    REQUIRE(groups.by_process(4).size() == 2);
+    REQUIRE(groups.by_type(3).size() == 3);
+}
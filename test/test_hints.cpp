@@ -0,0 +1,88 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <vector>
+
+namespace fake {
+
+    struct request {
+        HANDLE                          process;
+        VIRTUAL_MEMORY_INFORMATION_CLASS info_class;
+        std::vector<MEMORY_RANGE_ENTRY> ranges;
+        ULONG                           info;
+    };
+
+    std::vector<request> requests;
+
+    NTSTATUS NTAPI
+    NtSetInformationVirtualMemory(HANDLE                           process,
+                                  VIRTUAL_MEMORY_INFORMATION_CLASS info_class,
+                                  ULONG_PTR                        count,
+                                  PMEMORY_RANGE_ENTRY              ranges,
+                                  PVOID                            info,
+                                  ULONG                            info_size)
+    {
+        if(info_size != sizeof(ULONG))
+            return STATUS_INFO_LENGTH_MISMATCH;
+
+        requests.push_back({ process,
+                             info_class,
+                             { ranges, ranges + count },
+                             *static_cast<ULONG*>(info) });
+        return STATUS_SUCCESS;
+    }
+
+} // namespace fake
+
+#include <ntw/vm/hints.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+std::vector<ntw::vm::range> make_ranges()
+{
+    return { { reinterpret_cast<void*>(0x10000), 0x2000 },
+             { reinterpret_cast<void*>(0x40000), 0x100000 },
+             { reinterpret_cast<void*>(0x7000000), 0x1000 } };
+}
+
+TEST_CASE("prefetch issues a single request for all ranges")
+{
+    fake::requests.clear();
+
+    const auto ranges = make_ranges();
+    REQUIRE(ntw::vm::prefetch(ranges).success());
+    REQUIRE(fake::requests.size() == 1);
+
+    const auto& req = fake::requests[0];
+    REQUIRE(req.process == NtCurrentProcess());
+    REQUIRE(req.info_class == VmPrefetchInformation);
+    REQUIRE(req.info == 0);
+    REQUIRE(req.ranges.size() == ranges.size());
+    for(std::size_t i = 0; i < ranges.size(); ++i) {
+        REQUIRE(req.ranges[i].VirtualAddress == ranges[i].address);
+        REQUIRE(req.ranges[i].NumberOfBytes == ranges[i].size);
+    }
+
+    // nothing to do
+    REQUIRE(ntw::vm::prefetch({}).success());
+    REQUIRE(fake::requests.size() == 1);
+}
+
+TEST_CASE("set_page_priority passes the priority")
+{
+    fake::requests.clear();
+
+    const auto ranges  = make_ranges();
+    const auto process = reinterpret_cast<void*>(0x1234);
+    REQUIRE(ntw::vm::set_page_priority(
+                std::span(ranges).first(2), ntw::vm::page_priority::very_low, process)
+                .success());
+    REQUIRE(fake::requests.size() == 1);
+
+    const auto& req = fake::requests[0];
+    REQUIRE(req.process == process);
+    REQUIRE(req.info_class == VmPagePriorityInformation);
+    REQUIRE(req.info == MEMORY_PRIORITY_VERY_LOW);
+    REQUIRE(req.ranges.size() == 2);
+    REQUIRE(req.ranges[1].VirtualAddress == ranges[1].address);
+}
@@ -0,0 +1,40 @@
+#include <ntw/vm/large_pages.hpp>
+#include <ntw/vm/operation.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+#pragma comment(lib, "ntdll.lib")
+
+TEST_CASE("enable_privilege_once remembers the outcome")
+{
+    const auto first = ntw::ob::enable_privilege_once(ntw::ob::privilege::lock_memory());
+    REQUIRE_FALSE(first == STATUS_NOT_ALL_ASSIGNED);
+    for(int i = 0; i < 4; ++i)
+        REQUIRE(ntw::ob::enable_privilege_once(ntw::ob::privilege::lock_memory()) ==
+                first.get());
+}
+
+TEST_CASE("large_page_alloc falls back to regular pages")
+{
+    const auto minimum = ntw::vm::large_page_minimum();
+
+    const auto res = ntw::vm::large_page_alloc(0x1001);
+    REQUIRE(res.success());
+    REQUIRE(res->address != nullptr);
+
+    if(res->large_pages()) {
+        REQUIRE(minimum != 0);
+        REQUIRE(res->size == minimum);
+    }
+    else {
+        REQUIRE_FALSE(res->fallback_reason.success());
+        REQUIRE(res->size == 0x2000);
+    }
+
+    // the memory is committed and writable either way
+    static_cast<std::uint8_t*>(res->address)[res->size - 1] = 1;
+    REQUIRE(ntw::vm::release(res->address).success());
+
+    REQUIRE(ntw::vm::large_page_alloc(~std::size_t{ 0 }) == STATUS_INVALID_PARAMETER);
+}
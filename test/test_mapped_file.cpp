@@ -0,0 +1,193 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace fake {
+
+    using ::NtAllocateVirtualMemory;
+    using ::NtAllocateVirtualMemoryEx;
+    using ::NtDelayExecution;
+    using ::NtFreeVirtualMemory;
+    using ::NtMakePermanentObject;
+    using ::NtMakeTemporaryObject;
+    using ::NtOpenSection;
+    using ::NtWaitForSingleObject;
+
+    // the contents of the file, aligned so views can point straight into it
+    std::vector<std::uint8_t> storage;
+    std::uint8_t*             contents = nullptr;
+    std::uint64_t             size     = 0;
+
+    std::map<void*, SIZE_T> views;
+    std::size_t             maps = 0, sections = 0;
+
+    void reset(std::uint64_t file_size)
+    {
+        storage.assign(static_cast<std::size_t>(file_size) + 0x10000, 0);
+        void*       aligned = storage.data();
+        std::size_t space   = storage.size();
+        contents            = static_cast<std::uint8_t*>(
+            std::align(0x10000, static_cast<std::size_t>(file_size), aligned, space));
+        size = file_size;
+        for(std::uint64_t i = 0; i < size; ++i)
+            contents[i] = static_cast<std::uint8_t>(i / 7);
+        maps = 0;
+    }
+
+    NTSTATUS NTAPI NtCreateSection(PHANDLE       handle,
+                                   ACCESS_MASK   access,
+                                   POBJECT_ATTRIBUTES,
+                                   PLARGE_INTEGER max_size,
+                                   ULONG          prot,
+                                   ULONG          allocation,
+                                   HANDLE         file)
+    {
+        if(file != reinterpret_cast<HANDLE>(0x44) || max_size || prot != PAGE_READONLY ||
+           allocation != SEC_COMMIT || !(access & SECTION_MAP_READ))
+            return STATUS_INVALID_PARAMETER;
+        if(!size)
+            return STATUS_MAPPED_FILE_SIZE_ZERO;
+
+        ++sections;
+        *handle = reinterpret_cast<HANDLE>(0x88);
+        return STATUS_SUCCESS;
+    }
+
+    NTSTATUS NTAPI NtMapViewOfSection(HANDLE section,
+                                      HANDLE,
+                                      PVOID* base,
+                                      ULONG_PTR,
+                                      SIZE_T,
+                                      PLARGE_INTEGER offset,
+                                      PSIZE_T        view_size,
+                                      SECTION_INHERIT,
+                                      ULONG,
+                                      ULONG prot)
+    {
+        const auto start = static_cast<std::uint64_t>(offset->QuadPart);
+        if(section != reinterpret_cast<HANDLE>(0x88) || prot != PAGE_READONLY ||
+           start % 0x10000 || start + *view_size > size)
+            return STATUS_INVALID_VIEW_SIZE;
+
+        ++maps;
+        *base      = contents + start;
+        *view_size = (*view_size + 0xFFF) & ~SIZE_T{ 0xFFF };
+        views.emplace(*base, *view_size);
+        return STATUS_SUCCESS;
+    }
+
+    NTSTATUS NTAPI NtUnmapViewOfSection(HANDLE, PVOID base)
+    {
+        return views.erase(base) ? STATUS_SUCCESS : STATUS_NOT_MAPPED_VIEW;
+    }
+
+    NTSTATUS NTAPI NtClose(HANDLE handle)
+    {
+        if(handle == reinterpret_cast<HANDLE>(0x88))
+            --sections;
+        return STATUS_SUCCESS;
+    }
+
+} // namespace fake
+
+#include <ntw/io/mapped_file.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+struct fake_file {
+    ntw::result<std::uint64_t> size() const { return { STATUS_SUCCESS, fake::size }; }
+    void*                      get() const { return reinterpret_cast<void*>(0x44); }
+};
+
+TEST_CASE("map_view maps unaligned parts of the file")
+{
+    fake::reset(0x100000);
+    {
+        auto view = ntw::io::map_view(fake_file{}, 0x12345, 0x100);
+        REQUIRE(view.success());
+        REQUIRE(view->offset() == 0x12345);
+        REQUIRE(view->size() == 0x100);
+        REQUIRE(view->data() == fake::contents + 0x12345);
+        REQUIRE((*view)[0] == fake::contents[0x12345]);
+        REQUIRE(fake::views.size() == 1);
+
+        // only the view holds on to the section
+        REQUIRE(fake::sections == 0);
+
+        const auto whole = ntw::io::map_view(fake_file{});
+        REQUIRE(whole.success());
+        REQUIRE(whole->size() == 0x100000);
+        REQUIRE(whole->span().back() == fake::contents[0xFFFFF]);
+
+        const auto tail = ntw::io::map_view(fake_file{}, 0xFFFF0);
+        REQUIRE(tail.success());
+        REQUIRE(tail->size() == 0x10);
+
+        ntw::io::file_view moved = std::move(*view);
+        REQUIRE_FALSE(*view);
+        REQUIRE(moved.offset() == 0x12345);
+        REQUIRE(fake::views.size() == 3);
+    }
+    REQUIRE(fake::views.empty());
+
+    REQUIRE(ntw::io::map_view(fake_file{}, 0x100000, 1) == STATUS_END_OF_FILE);
+    REQUIRE(ntw::io::map_view(fake_file{}, 0x100001) == STATUS_END_OF_FILE);
+
+    const auto end = ntw::io::map_view(fake_file{}, 0x100000);
+    REQUIRE(end.success());
+    REQUIRE(end->empty());
+
+    fake::reset(0);
+    REQUIRE(ntw::io::map_view(fake_file{}).success());
+}
+
+TEST_CASE("mapped_file slides its window")
+{
+    fake::reset(0x500000);
+
+    ntw::io::mapped_file file;
+    REQUIRE(file.open(fake_file{}, 0x18000).success());
+    REQUIRE(file.size() == 0x500000);
+    REQUIRE(file.window() == 0x20000);
+    REQUIRE(fake::maps == 0);
+
+    const auto check = [&](std::uint64_t offset, std::size_t length) {
+        const auto data = file.view(offset, length);
+        REQUIRE(data.success());
+        REQUIRE(data->size() == length);
+        REQUIRE(data->data() == fake::contents + offset);
+        REQUIRE(fake::views.size() == 1);
+    };
+
+    // walking forward only remaps once the window is left
+    for(std::uint64_t offset = 0; offset < 0x40000; offset += 0x1000)
+        check(offset, 0x1000);
+    REQUIRE(fake::maps == 2);
+
+    // straddles the end of the window
+    check(0x5FF00, 0x200);
+    REQUIRE(fake::maps == 3);
+    REQUIRE(file.current().offset() == 0x50000);
+
+    // larger than the window
+    check(0x100010, 0x30000);
+    REQUIRE(fake::maps == 4);
+    REQUIRE(file.current().size() == 0x30010);
+
+    // the window is clipped to the end of the file
+    check(0x4FFFFF, 1);
+    REQUIRE(file.current().size() == 0x10000);
+
+    REQUIRE(file.view(0x4FFFFF, 2) == STATUS_END_OF_FILE);
+    REQUIRE(file.view(0x500000, 0).success());
+
+    REQUIRE(file.unmap().success());
+    REQUIRE(fake::views.empty());
+
+    fake::reset(0);
+    REQUIRE(file.open(fake_file{}).success());
+    REQUIRE(file.view(0, 1) == STATUS_END_OF_FILE);
+}
@@ -0,0 +1,65 @@
+#include <ntw/sys/module_index.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+#include <vector>
+
+#pragma comment(lib, "ntdll.lib")
+
+// builds a SystemModuleInformationEx blob from (base, size) pairs
+std::vector<ntw::sys::loaded_module>
+make_modules(const std::vector<std::pair<std::uintptr_t, ntw::ulong_t>>& ranges)
+{
+    std::vector<ntw::sys::loaded_module> modules(ranges.size() + 1);
+    for(std::size_t i = 0; i < ranges.size(); ++i) {
+        modules[i].offset_to_next = sizeof(ntw::sys::loaded_module);
+        modules[i].image_base     = reinterpret_cast<void*>(ranges[i].first);
+        modules[i].image_size     = ranges[i].second;
+    }
+    // the last entry terminates the list
+    modules.back().offset_to_next = 0;
+    return modules;
+}
+
+TEST_CASE("module_index resolves addresses")
+{
+    auto modules = make_modules(
+        { { 0x5000, 0x1000 }, { 0x1000, 0x1000 }, { 0x3000, 0x800 }, { 0x9000, 0x100 } });
+
+    ntw::sys::module_index index;
+    ntw::sys::loaded_module::range_type range{ modules.data() };
+    REQUIRE(index.assign(range).success());
+    REQUIRE(index.size() == 4);
+    REQUIRE(index.intervals()[0].base == 0x1000);
+
+    CHECK(index.find(std::uintptr_t{ 0x500 }) == nullptr);
+    CHECK(index.find(std::uintptr_t{ 0x1000 }) == &modules[1]);
+    CHECK(index.find(std::uintptr_t{ 0x1fff }) == &modules[1]);
+    CHECK(index.find(std::uintptr_t{ 0x2000 }) == nullptr);
+    CHECK(index.find(std::uintptr_t{ 0x37ff }) == &modules[2]);
+    CHECK(index.find(std::uintptr_t{ 0x3800 }) == nullptr);
+    CHECK(index.find(std::uintptr_t{ 0x5800 }) == &modules[0]);
+    CHECK(index.find(std::uintptr_t{ 0x90ff }) == &modules[3]);
+    CHECK(index.find(std::uintptr_t{ 0x9100 }) == nullptr);
+}
+
+TEST_CASE("module_index batch find matches single lookups")
+{
+    std::vector<std::pair<std::uintptr_t, ntw::ulong_t>> ranges;
+    for(std::uintptr_t i = 0; i < 300; ++i)
+        ranges.emplace_back(0x100000 + i * 0x3000, 0x2000);
+    auto modules = make_modules(ranges);
+
+    ntw::sys::module_index index;
+    ntw::sys::loaded_module::range_type range{ modules.data() };
+    REQUIRE(index.assign(range).success());
+
+    std::vector<std::uintptr_t> addresses;
+    for(std::uintptr_t a = 0xff000; a < 0x100000 + 300 * 0x3000 + 0x1000; a += 0x7ff)
+        addresses.push_back(a);
+
+    std::vector<const ntw::sys::loaded_module*> found(addresses.size());
+    index.find(addresses, found);
+    for(std::size_t i = 0; i < addresses.size(); ++i)
+        REQUIRE(found[i] == index.find(addresses[i]));
+}
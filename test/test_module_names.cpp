@@ -0,0 +1,71 @@
+#include <ntw/sys/module_names.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <vector>
+
+#pragma comment(lib, "ntdll.lib")
+
+std::vector<ntw::sys::loaded_module> make_modules(const std::vector<const char*>& paths)
+{
+    std::vector<ntw::sys::loaded_module> modules(paths.size() + 1);
+    for(std::size_t i = 0; i < paths.size(); ++i) {
+        auto& m          = modules[i];
+        m.offset_to_next = sizeof(ntw::sys::loaded_module);
+        std::strcpy(m.path, paths[i]);
+        m.file_name_offset =
+            static_cast<std::uint16_t>(std::strrchr(paths[i], '\\') + 1 - paths[i]);
+    }
+    // the last entry terminates the list
+    modules.back().offset_to_next = 0;
+    return modules;
+}
+
+TEST_CASE("loaded_module name_view")
+{
+    auto modules = make_modules({ "\\SystemRoot\\system32\\ntoskrnl.exe",
+                                  "\\SystemRoot\\System32\\drivers\\a_driver_name_longer_"
+                                  "than_several_vector_widths.sys" });
+
+    REQUIRE(modules[0].name_view() == "ntoskrnl.exe");
+    REQUIRE(modules[0].path_view() == "\\SystemRoot\\system32\\ntoskrnl.exe");
+    REQUIRE(modules[1].name_view() ==
+            "a_driver_name_longer_than_several_vector_widths.sys");
+
+    // a name which fills the path buffer is not null terminated
+    std::memset(modules[0].path, 'a', sizeof(modules[0].path));
+    modules[0].file_name_offset = 10;
+    REQUIRE(modules[0].name_view().size() == sizeof(modules[0].path) - 10);
+
+    // the name offset of a malformed entry is past the end of the path
+    modules[1].file_name_offset = sizeof(modules[1].path) + 4;
+    REQUIRE(modules[1].name_view().empty());
+    REQUIRE(modules[1].path_view() ==
+            "\\SystemRoot\\System32\\drivers\\a_driver_name_longer_"
+            "than_several_vector_widths.sys");
+}
+
+TEST_CASE("module_name_table finds modules ignoring case")
+{
+    auto modules = make_modules({ "\\SystemRoot\\system32\\ntoskrnl.exe",
+                                  "\\SystemRoot\\system32\\hal.dll",
+                                  "\\SystemRoot\\System32\\drivers\\CLFS.SYS",
+                                  "\\SystemRoot\\System32\\drivers\\tcpip.sys" });
+
+    ntw::sys::module_name_table table;
+    REQUIRE(table.empty());
+    REQUIRE(table.find("hal.dll") == nullptr);
+
+    ntw::sys::loaded_module::range_type range{ modules.data() };
+    REQUIRE(table.assign(range).success());
+    REQUIRE(table.size() == 4);
+
+    CHECK(table.find("ntoskrnl.exe") == &modules[0]);
+    CHECK(table.find("NTOSKRNL.EXE") == &modules[0]);
+    CHECK(table.find("Hal.dll") == &modules[1]);
+    CHECK(table.find("clfs.sys") == &modules[2]);
+    CHECK(table.find("tcpip.sys") == &modules[3]);
+    CHECK(table.find("tcpip.sy") == nullptr);
+    CHECK(table.find("system32\\hal.dll") == nullptr);
+}
@@ -0,0 +1,73 @@
+#include <ntw/offset_index.hpp>
+#include <ntw/sys/processes.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+#include <iterator>
+#include <vector>
+
+#pragma comment(lib, "ntdll.lib")
+
+// builds a SystemProcessInformation blob without threads using the given pids
+std::vector<std::uint8_t> make_blob(const std::vector<std::uintptr_t>& pids)
+{
+    std::vector<std::uint8_t> blob((pids.size() + 1) * sizeof(ntw::sys::process));
+    auto                      p = reinterpret_cast<ntw::sys::process*>(blob.data());
+    for(auto pid : pids) {
+        p->offset_to_next = sizeof(ntw::sys::process);
+        p->id             = pid;
+        ++p;
+    }
+    return blob;
+}
+
+TEST_CASE("offset_index records every entry")
+{
+    std::vector<std::uintptr_t> pids;
+    for(std::uintptr_t i = 0; i < 5000; ++i)
+        pids.push_back(((i * 7919) % 5000) * 4);
+
+    auto blob = make_blob(pids);
+
+    ntw::offset_index<ntw::sys::process> index;
+    REQUIRE(index.assign(ntw::sys::process::range_type{
+                             reinterpret_cast<ntw::sys::process*>(blob.data()) })
+                .success());
+    REQUIRE(index.size() == pids.size());
+
+    static_assert(std::random_access_iterator<decltype(index.begin())>);
+    // swapping the entries would separate them from their trailing data
+    static_assert(!std::sortable<decltype(index.begin())>);
+    static_assert(!std::indirectly_swappable<decltype(index.begin())>);
+    for(std::size_t i = 0; i < pids.size(); ++i)
+        CHECK(index[i].id == pids[i]);
+
+    SECTION("sorting and searching by key")
+    {
+        const auto pid = [](const ntw::sys::process& p) { return p.id; };
+        index.sort_by(pid);
+        REQUIRE(std::is_sorted(index.begin(), index.end(), [](auto& lhs, auto& rhs) {
+            return lhs.id < rhs.id;
+        }));
+
+        for(std::uintptr_t i = 0; i < 5000; i += 97) {
+            const auto p = index.find(i * 4, pid);
+            REQUIRE(p != nullptr);
+            CHECK(p->id == i * 4);
+        }
+
+        REQUIRE(index.find(std::uintptr_t{ 3 }, pid) == nullptr);
+        REQUIRE(index.find(std::uintptr_t{ 5000 * 4 }, pid) == nullptr);
+    }
+
+    SECTION("reassigning reuses the storage")
+    {
+        auto small = make_blob({ 8, 4 });
+        REQUIRE(index.assign(ntw::sys::process::range_type{
+                                 reinterpret_cast<ntw::sys::process*>(small.data()) })
+                    .success());
+        REQUIRE(index.size() == 2);
+        REQUIRE(index.end() - index.begin() == 2);
+        REQUIRE(index.begin()->id == 8);
+    }
+}
@@ -0,0 +1,226 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <vector>
+
+namespace fake {
+
+    using ::NtAllocateVirtualMemory;
+    using ::NtAllocateVirtualMemoryEx;
+    using ::NtClose;
+    using ::NtFreeVirtualMemory;
+    using ::NtUnmapViewOfSection;
+
+    // 64 pages of memory at 0x100000 where every byte depends on its address and on the
+    // version which is bumped to simulate writes by the target
+    constexpr std::uintptr_t base       = 0x100000;
+    constexpr std::size_t    size       = 0x40000;
+    std::uintptr_t           unreadable = 0;
+    std::uint8_t             version    = 0;
+    std::size_t              reads      = 0;
+
+    std::uint8_t byte_at(std::uintptr_t address)
+    {
+        return static_cast<std::uint8_t>(address ^ (address >> 8) ^ version);
+    }
+
+    NTSTATUS NTAPI
+    NtReadVirtualMemory(HANDLE, PVOID address, PVOID buffer, SIZE_T length, PSIZE_T)
+    {
+        ++reads;
+        const auto a = reinterpret_cast<std::uintptr_t>(address);
+        if(a < base || a + length > base + size ||
+           (unreadable >= (a & ~std::uintptr_t{ 0xFFF }) && unreadable < a + length))
+            return STATUS_PARTIAL_COPY;
+
+        for(SIZE_T i = 0; i < length; ++i)
+            static_cast<std::uint8_t*>(buffer)[i] = byte_at(a + i);
+        return STATUS_SUCCESS;
+    }
+
+} // namespace fake
+
+#include <ntw/vm/page_cache.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+bool holds_memory(std::uintptr_t address, const std::vector<std::uint8_t>& buffer)
+{
+    for(std::size_t i = 0; i < buffer.size(); ++i)
+        if(buffer[i] != fake::byte_at(address + i))
+            return false;
+    return true;
+}
+
+void reset_fake()
+{
+    fake::unreadable = 0;
+    fake::version    = 0;
+    fake::reads      = 0;
+}
+
+TEST_CASE("page_cache without storage reads directly")
+{
+    reset_fake();
+
+    ntw::vm::page_cache       cache;
+    std::vector<std::uint8_t> buffer(16);
+    REQUIRE(cache.read_mem(fake::base + 8, buffer).success());
+    REQUIRE(cache.read_mem(fake::base + 8, buffer).success());
+    REQUIRE(fake::reads == 2);
+    REQUIRE(holds_memory(fake::base + 8, buffer));
+}
+
+TEST_CASE("page_cache serves repeated reads from copied pages")
+{
+    reset_fake();
+
+    ntw::vm::page_cache cache;
+    REQUIRE(cache.reserve(4).success());
+    REQUIRE(cache.capacity() == 4);
+
+    std::vector<std::uint8_t> buffer(8);
+    for(int i = 0; i < 10; ++i) {
+        REQUIRE(cache.read_mem(fake::base + 0x10, buffer).success());
+        REQUIRE(holds_memory(fake::base + 0x10, buffer));
+    }
+    REQUIRE(fake::reads == 1);
+
+    // crosses into the next page
+    REQUIRE(cache.read_mem(fake::base + 0xFFC, buffer).success());
+    REQUIRE(holds_memory(fake::base + 0xFFC, buffer));
+    REQUIRE(fake::reads == 2);
+
+    std::vector<std::uint8_t> large(0x2800);
+    REQUIRE(cache.read_mem(fake::base + 0x800, large).success());
+    REQUIRE(holds_memory(fake::base + 0x800, large));
+    REQUIRE(fake::reads == 3);
+}
+
+TEST_CASE("page_cache evicts the least recently used page")
+{
+    reset_fake();
+
+    ntw::vm::page_cache cache;
+    REQUIRE(cache.reserve(2).success());
+
+    std::uint32_t value;
+    const auto    read = [&](std::uintptr_t page) {
+        return cache.read_mem(fake::base + page * 0x1000, &value, sizeof(value));
+    };
+
+    REQUIRE(read(0).success());
+    REQUIRE(read(1).success());
+    REQUIRE(read(0).success());
+    REQUIRE(fake::reads == 2);
+
+    // 1 is the least recently used page
+    REQUIRE(read(2).success());
+    REQUIRE(read(0).success());
+    REQUIRE(fake::reads == 3);
+    REQUIRE(read(1).success());
+    REQUIRE(fake::reads == 4);
+}
+
+TEST_CASE("page_cache invalidation")
+{
+    reset_fake();
+
+    ntw::vm::page_cache cache;
+    REQUIRE(cache.reserve(8).success());
+
+    std::vector<std::uint8_t> first(8), second(8);
+    REQUIRE(cache.read_mem(fake::base, first).success());
+    REQUIRE(cache.read_mem(fake::base + 0x1000, second).success());
+
+    // stale data is returned until the cache is told otherwise
+    fake::version = 1;
+    REQUIRE(cache.read_mem(fake::base, first).success());
+    REQUIRE_FALSE(holds_memory(fake::base, first));
+    REQUIRE(fake::reads == 2);
+
+    cache.invalidate(fake::base + 0xFF0, 0x10);
+    REQUIRE(cache.read_mem(fake::base, first).success());
+    REQUIRE(cache.read_mem(fake::base + 0x1000, second).success());
+    REQUIRE(holds_memory(fake::base, first));
+    REQUIRE_FALSE(holds_memory(fake::base + 0x1000, second));
+    REQUIRE(fake::reads == 3);
+
+    const auto generation = cache.generation();
+    cache.invalidate();
+    REQUIRE(cache.generation() == generation + 1);
+    REQUIRE(cache.read_mem(fake::base + 0x1000, second).success());
+    REQUIRE(holds_memory(fake::base + 0x1000, second));
+    REQUIRE(fake::reads == 4);
+}
+
+TEST_CASE("page_cache invalidation of ranges larger than the cache")
+{
+    reset_fake();
+
+    ntw::vm::page_cache cache;
+    REQUIRE(cache.reserve(4).success());
+
+    std::vector<std::uint8_t> buffer(8);
+    for(const auto page : { 0x0, 0x1000, 0x8000 })
+        REQUIRE(cache.read_mem(fake::base + page, buffer).success());
+    REQUIRE(fake::reads == 3);
+
+    fake::version = 1;
+    cache.invalidate(fake::base + 0x1800, 0x10000000);
+
+    // the page before the range is still served from the cache
+    REQUIRE(cache.read_mem(fake::base, buffer).success());
+    REQUIRE_FALSE(holds_memory(fake::base, buffer));
+    for(const auto page : { 0x1000, 0x8000 }) {
+        REQUIRE(cache.read_mem(fake::base + page, buffer).success());
+        REQUIRE(holds_memory(fake::base + page, buffer));
+    }
+    REQUIRE(fake::reads == 5);
+}
+
+TEST_CASE("page_cache does not keep unreadable pages")
+{
+    reset_fake();
+    fake::unreadable = fake::base + 0x3000;
+
+    ntw::vm::page_cache cache;
+    REQUIRE(cache.reserve(4).success());
+
+    std::vector<std::uint8_t> buffer(16);
+    REQUIRE(cache.read_mem(fake::base + 0x2FF8, buffer) == STATUS_PARTIAL_COPY);
+    REQUIRE(cache.read_mem(fake::base + 0x3000, buffer) == STATUS_PARTIAL_COPY);
+    REQUIRE(fake::reads == 3);
+
+    // the readable page stays cached
+    REQUIRE(cache.read_mem(fake::base + 0x2F00, buffer).success());
+    REQUIRE(holds_memory(fake::base + 0x2F00, buffer));
+    REQUIRE(fake::reads == 3);
+}
+
+TEST_CASE("page_cache stays consistent under heavy eviction")
+{
+    reset_fake();
+
+    ntw::vm::page_cache cache;
+    REQUIRE(cache.reserve(8).success());
+
+    std::vector<std::uint8_t> buffer(24);
+    std::uint32_t             seed = 1;
+    for(int i = 0; i < 20000; ++i) {
+        seed               = seed * 1103515245 + 12345;
+        const auto address = fake::base + (seed >> 8) % (fake::size - buffer.size());
+        if(i % 1000 == 999) {
+            ++fake::version;
+            cache.invalidate();
+        }
+
+        REQUIRE(cache.read_mem(address, buffer).success());
+        REQUIRE(holds_memory(address, buffer));
+
+        // the pages that were just used are always cached
+        const auto reads = fake::reads;
+        REQUIRE(cache.read_mem(address, buffer).success());
+        REQUIRE(fake::reads == reads);
+    }
+}
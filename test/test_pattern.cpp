@@ -0,0 +1,235 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fake {
+
+    using ::NtAllocateVirtualMemory;
+    using ::NtAllocateVirtualMemoryEx;
+    using ::NtFreeVirtualMemory;
+    using ::NtUnmapViewOfSection;
+
+    constexpr std::uintptr_t base = 0x10000;
+
+    std::vector<MEMORY_BASIC_INFORMATION> regions;
+    std::vector<std::uint8_t>             memory(0x30000);
+    std::size_t                           threads = 0;
+
+    NTSTATUS NTAPI NtQueryVirtualMemory(HANDLE,
+                                        PVOID                    address,
+                                        MEMORY_INFORMATION_CLASS info_class,
+                                        PVOID                    buffer,
+                                        SIZE_T,
+                                        PSIZE_T)
+    {
+        const auto a = reinterpret_cast<std::uintptr_t>(address);
+        for(const auto& r : regions) {
+            const auto base = reinterpret_cast<std::uintptr_t>(r.BaseAddress);
+            if(a >= base && a < base + r.RegionSize) {
+                *static_cast<MEMORY_BASIC_INFORMATION*>(buffer) = r;
+                return STATUS_SUCCESS;
+            }
+        }
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    NTSTATUS NTAPI
+    NtReadVirtualMemory(HANDLE, PVOID address, PVOID buffer, SIZE_T length, PSIZE_T)
+    {
+        const auto a = reinterpret_cast<std::uintptr_t>(address);
+        if(a < base || a + length > base + memory.size())
+            return STATUS_PARTIAL_COPY;
+
+        std::memcpy(buffer, memory.data() + (a - base), length);
+        return STATUS_SUCCESS;
+    }
+
+    NTSTATUS NTAPI NtCreateThreadEx(PHANDLE handle,
+                                    ACCESS_MASK,
+                                    OBJECT_ATTRIBUTES*,
+                                    HANDLE,
+                                    PUSER_THREAD_START_ROUTINE routine,
+                                    PVOID                      argument,
+                                    ULONG,
+                                    SIZE_T,
+                                    SIZE_T,
+                                    SIZE_T,
+                                    PS_ATTRIBUTE_LIST*)
+    {
+        ++threads;
+        *handle = new std::thread(routine, argument);
+        return STATUS_SUCCESS;
+    }
+
+    NTSTATUS NTAPI NtWaitForSingleObject(HANDLE handle, BOOLEAN, PLARGE_INTEGER)
+    {
+        static_cast<std::thread*>(handle)->join();
+        return STATUS_SUCCESS;
+    }
+
+    NTSTATUS NTAPI NtClose(HANDLE handle)
+    {
+        delete static_cast<std::thread*>(handle);
+        return STATUS_SUCCESS;
+    }
+
+    void add(std::uintptr_t base, SIZE_T size, ULONG state, ULONG protect)
+    {
+        auto& r       = regions.emplace_back();
+        r.BaseAddress = reinterpret_cast<void*>(base);
+        r.RegionSize  = size;
+        r.State       = state;
+        r.Protect     = protect;
+        r.Type        = MEM_PRIVATE;
+    }
+
+} // namespace fake
+
+#include <ntw/vm/pattern_scan.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+std::vector<std::uint8_t> bytes(std::initializer_list<int> values)
+{
+    return { values.begin(), values.end() };
+}
+
+TEST_CASE("pattern parsing")
+{
+    const auto p = ntw::vm::pattern::parse("48 8B ?? ? 4? ?F");
+    REQUIRE(p.success());
+    REQUIRE(p->size() == 6);
+
+    const auto match = bytes({ 0x48, 0x8B, 0x00, 0xFF, 0x4C, 0x1F });
+    REQUIRE(p->matches(match.data()));
+
+    const auto nibble = bytes({ 0x48, 0x8B, 0x00, 0xFF, 0x5C, 0x1F });
+    REQUIRE_FALSE(p->matches(nibble.data()));
+
+    REQUIRE(ntw::vm::pattern::parse("  e8 ?? ?? ?? ??  ").success());
+    REQUIRE(ntw::vm::pattern::parse("") == STATUS_INVALID_PARAMETER);
+    REQUIRE(ntw::vm::pattern::parse("48 8") == STATUS_INVALID_PARAMETER);
+    REQUIRE(ntw::vm::pattern::parse("48 8G") == STATUS_INVALID_PARAMETER);
+    REQUIRE(ntw::vm::pattern::parse("488B") == STATUS_INVALID_PARAMETER);
+
+    std::string too_long;
+    for(std::size_t i = 0; i <= ntw::vm::pattern::max_size; ++i)
+        too_long += "90 ";
+    REQUIRE(ntw::vm::pattern::parse(too_long) == STATUS_INVALID_PARAMETER);
+}
+
+TEST_CASE("pattern from code style mask")
+{
+    const auto code = bytes({ 0xE8, 0, 0, 0, 0, 0x90 });
+    const auto p    = ntw::vm::pattern::from_mask(code, "x????x");
+    REQUIRE(p.success());
+
+    const auto match = bytes({ 0xE8, 1, 2, 3, 4, 0x90 });
+    REQUIRE(p->matches(match.data()));
+
+    REQUIRE(ntw::vm::pattern::from_mask(code, "x????") == STATUS_INVALID_PARAMETER);
+    REQUIRE(ntw::vm::pattern::from_mask(code, "x????y") == STATUS_INVALID_PARAMETER);
+}
+
+TEST_CASE("pattern find agrees with a naive search")
+{
+    // a tiny alphabet produces plenty of first and last byte candidates
+    std::vector<std::uint8_t> data(10000);
+    std::uint32_t             seed = 7;
+    for(auto& b : data) {
+        seed = seed * 1103515245 + 12345;
+        b    = static_cast<std::uint8_t>((seed >> 16) % 3);
+    }
+
+    const char* patterns[] = {
+        "01 02", "00 ?? 01 02", "?? 02 00 01 ??", "0? 01", "?? ??"
+    };
+    for(const auto text : patterns) {
+        const auto p = ntw::vm::pattern::parse(text);
+        REQUIRE(p.success());
+
+        std::vector<std::size_t> expected, found;
+        for(std::size_t i = 0; i + p->size() <= data.size(); ++i)
+            if(p->matches(data.data() + i))
+                expected.push_back(i);
+
+        for(auto i = p->find(data); i != ntw::vm::pattern::npos; i = p->find(data, i + 1))
+            found.push_back(i);
+
+        REQUIRE(found == expected);
+    }
+
+    const auto p = ntw::vm::pattern::parse("00 01");
+    REQUIRE(p->find(std::span(data).first(1)) == ntw::vm::pattern::npos);
+    REQUIRE(p->find(data, data.size()) == ntw::vm::pattern::npos);
+}
+
+TEST_CASE("pattern_scanner scans readable committed memory")
+{
+    fake::regions.clear();
+    fake::add(0x00000, 0x10000, MEM_FREE, PAGE_NOACCESS);
+    fake::add(0x10000, 0x8000, MEM_COMMIT, PAGE_READWRITE);
+    fake::add(0x18000, 0x8000, MEM_COMMIT, PAGE_EXECUTE_READ);
+    fake::add(0x20000, 0x10000, MEM_RESERVE, 0);
+    fake::add(0x30000, 0x4000, MEM_COMMIT, PAGE_READWRITE);
+    fake::add(0x34000, 0x1000, MEM_COMMIT, PAGE_READWRITE | PAGE_GUARD);
+    fake::add(0x35000, 0xB000, MEM_COMMIT, PAGE_NOACCESS);
+
+    std::uint32_t seed = 1;
+    for(auto& b : fake::memory) {
+        seed = seed * 1103515245 + 12345;
+        b    = static_cast<std::uint8_t>((seed >> 16) & 0x7F);
+    }
+
+    const auto plant = [](std::uintptr_t address, std::initializer_list<int> values) {
+        const auto offset = static_cast<std::ptrdiff_t>(address - fake::base);
+        std::copy(values.begin(), values.end(), fake::memory.begin() + offset);
+    };
+
+    // crossing chunk and region borders, in reserved, guarded and inaccessible memory
+    const std::uintptr_t expected[] = { 0x10100, 0x10FFE, 0x17FFD, 0x33FFA };
+    for(const auto address : expected)
+        plant(address, { 0xCC, 0xE8, 0x90, 0x90, 0xC3, 0xCC });
+    plant(0x2F000, { 0xCC, 0xE8, 0x90, 0x90, 0xC3, 0xCC });
+    plant(0x34010, { 0xCC, 0xE8, 0x90, 0x90, 0xC3, 0xCC });
+    plant(0x36000, { 0xCC, 0xE8, 0x90, 0x90, 0xC3, 0xCC });
+    plant(0x18800, { 0xFF, 0x25 });
+
+    const ntw::vm::pattern patterns[] = { *ntw::vm::pattern::parse("CC E8 ?? ?? C3 CC"),
+                                          *ntw::vm::pattern::parse("FF 25") };
+
+    for(const std::size_t workers : { 1, 4 }) {
+        fake::threads = 0;
+
+        std::mutex                          lock;
+        std::vector<ntw::vm::pattern_match> matches;
+
+        const auto status = ntw::vm::pattern_scanner{}
+                                .workers(workers)
+                                .chunk_size(0x1000)
+                                .scan(patterns, [&](const ntw::vm::pattern_match& m) {
+                                    std::lock_guard guard(lock);
+                                    matches.push_back(m);
+                                });
+        REQUIRE(status.success());
+        REQUIRE(fake::threads == workers - 1);
+
+        std::sort(matches.begin(), matches.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.address < rhs.address;
+        });
+
+        REQUIRE(matches.size() == 5);
+        for(std::size_t i = 0, j = 0; i < matches.size(); ++i) {
+            if(matches[i].pattern == 1) {
+                REQUIRE(matches[i].address == 0x18800);
+                continue;
+            }
+            REQUIRE(matches[i].address == expected[j++]);
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#include <ntw/vm/pinned_pool.hpp>
+#include <ntw/vm/working_set.hpp>
+#include <set>
+#include <thread>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+#pragma comment(lib, "ntdll.lib")
+
+TEST_CASE("pinned_pool hands out every buffer once")
+{
+    ntw::vm::pinned_pool pool;
+    REQUIRE(pool.acquire() == nullptr);
+    REQUIRE(pool.create(0, 1) == STATUS_INVALID_PARAMETER);
+    REQUIRE(pool.create(1, 0) == STATUS_INVALID_PARAMETER);
+    REQUIRE(pool.create(~std::size_t{ 0 } / 2, 4) == STATUS_INVALID_PARAMETER);
+
+    REQUIRE(pool.create(100, 8).success());
+    REQUIRE(pool.buffer_size() == 128);
+    REQUIRE(pool.count() == 8);
+
+    std::set<void*> buffers;
+    for(std::size_t i = 0; i < pool.count(); ++i) {
+        const auto buffer = pool.acquire();
+        REQUIRE(buffer != nullptr);
+        REQUIRE(pool.contains(buffer));
+        REQUIRE(reinterpret_cast<std::uintptr_t>(buffer) % 64 == 0);
+        std::memset(buffer, 0xAB, pool.buffer_size());
+        buffers.insert(buffer);
+    }
+    REQUIRE(buffers.size() == pool.count());
+    REQUIRE(pool.acquire() == nullptr);
+    REQUIRE_FALSE(pool.contains(static_cast<std::uint8_t*>(pool.data()) + 8 * 128));
+
+    // the last released buffer is handed out first
+    const auto last = *buffers.begin();
+    pool.release(*buffers.rbegin());
+    pool.release(last);
+    REQUIRE(pool.acquire() == last);
+    REQUIRE(pool.acquire() == *buffers.rbegin());
+    REQUIRE(pool.acquire() == nullptr);
+}
+
+TEST_CASE("pinned_pool buffers are locked")
+{
+    ntw::vm::pinned_pool pool;
+    REQUIRE(pool.create(0x1000, 64).success());
+
+    ntw::vm::residency_map map;
+    REQUIRE(map.query(pool.data(), pool.buffer_size() * pool.count()).success());
+    for(std::size_t i = 0; i < map.size(); ++i) {
+        REQUIRE(map.resident(i));
+        REQUIRE(map.locked(i));
+    }
+}
+
+TEST_CASE("pinned_pool between threads")
+{
+    ntw::vm::pinned_pool pool;
+    REQUIRE(pool.create(64, 16).success());
+
+    std::atomic<bool>        exclusive = true;
+    std::vector<std::thread> threads;
+    for(std::uint32_t id = 1; id <= 4; ++id) {
+        threads.emplace_back([&, id] {
+            for(std::uint32_t i = 0; i < 200000; ++i) {
+                const auto buffer = static_cast<std::uint32_t*>(pool.acquire());
+                if(!buffer)
+                    continue;
+
+                // nobody else may touch the buffer while we own it
+                buffer[0] = id;
+                buffer[1] = i;
+                if(buffer[0] != id || buffer[1] != i)
+                    exclusive = false;
+                pool.release(buffer);
+            }
+        });
+    }
+
+    for(auto& thread : threads)
+        thread.join();
+    REQUIRE(exclusive);
+
+    // every buffer made it back
+    std::size_t available = 0;
+    while(pool.acquire())
+        ++available;
+    REQUIRE(available == pool.count());
+}
@@ -0,0 +1,85 @@
+#include <ntw/sys/pool_tag_filter.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#pragma comment(lib, "ntdll.lib")
+
+std::uint32_t make_tag(const char* name)
+{
+    std::uint32_t tag;
+    std::memcpy(&tag, name, 4);
+    return tag;
+}
+
+std::vector<ntw::sys::system_pooltag> make_tags(const std::vector<std::string>& names)
+{
+    std::vector<ntw::sys::system_pooltag> tags(names.size());
+    for(std::size_t i = 0; i < names.size(); ++i)
+        std::memcpy(&tags[i].tag, names[i].data(), 4);
+    return tags;
+}
+
+TEST_CASE("pool_tag_pattern parsing")
+{
+    constexpr ntw::sys::pool_tag_pattern prefix("Nt*");
+    REQUIRE(prefix.matches(make_tag("NtFs")));
+    REQUIRE(prefix.matches(make_tag("Nt  ")));
+    REQUIRE_FALSE(prefix.matches(make_tag("MtFs")));
+    REQUIRE_FALSE(prefix.matches(make_tag("nTFs")));
+
+    ntw::sys::pool_tag_pattern any_char("Ob?j");
+    REQUIRE(any_char.matches(make_tag("ObDj")));
+    REQUIRE_FALSE(any_char.matches(make_tag("ObDi")));
+
+    ntw::sys::pool_tag_pattern padded("Mm");
+    REQUIRE(padded.matches(make_tag("Mm  ")));
+    REQUIRE_FALSE(padded.matches(make_tag("MmSt")));
+
+    REQUIRE(ntw::sys::pool_tag_pattern("*").matches(make_tag("Abcd")));
+}
+
+TEST_CASE("pool_tag_filter with few patterns")
+{
+    auto tags = make_tags(
+        { "NtFs", "File", "Ntf0", "Proc", "Thre", "NtFr", "Toke", "Ntfx", "MmSt" });
+
+    ntw::sys::pool_tag_filter filter;
+    REQUIRE(filter.add("NtF*").success());
+    REQUIRE(filter.add("Pro?").success());
+
+    std::vector<std::uint32_t> out(tags.size());
+    REQUIRE(filter.filter(tags, out) == 3);
+    REQUIRE(out[0] == 0);
+    REQUIRE(out[1] == 3);
+    REQUIRE(out[2] == 5);
+
+    // a small output stops the filtering
+    REQUIRE(filter.filter(tags, std::span(out).first(2)) == 2);
+}
+
+TEST_CASE("pool_tag_filter with a large suspect list")
+{
+    std::vector<std::string> names, suspects;
+    for(int i = 0; i < 10000; ++i) {
+        char name[5];
+        std::snprintf(name, sizeof(name), "%04d", i);
+        names.emplace_back(name);
+        if(i % 50 == 7)
+            suspects.emplace_back(name);
+    }
+    auto tags = make_tags(names);
+
+    ntw::sys::pool_tag_filter filter;
+    REQUIRE(filter.add_range(suspects).success());
+    REQUIRE(filter.size() == 200);
+
+    std::vector<std::uint32_t> out(tags.size());
+    REQUIRE(filter.filter(tags, out) == 200);
+    for(std::size_t i = 0; i < 200; ++i)
+        REQUIRE(out[i] == i * 50 + 7);
+}
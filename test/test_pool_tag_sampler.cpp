@@ -0,0 +1,137 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace fake {
+
+    using ::NtAllocateVirtualMemoryEx;
+    using ::NtClose;
+    using ::NtDelayExecution;
+    using ::NtUnmapViewOfSection;
+
+    std::size_t                 allocations = 0;
+    std::vector<SYSTEM_POOLTAG> tags;
+
+    NTSTATUS NTAPI NtAllocateVirtualMemory(
+        HANDLE, PVOID* base, ULONG_PTR, PSIZE_T size, ULONG, ULONG)
+    {
+        ++allocations;
+        *base = std::calloc(*size, 1);
+        return *base ? STATUS_SUCCESS : STATUS_NO_MEMORY;
+    }
+
+    NTSTATUS NTAPI NtFreeVirtualMemory(HANDLE, PVOID* base, PSIZE_T, ULONG)
+    {
+        std::free(*base);
+        return STATUS_SUCCESS;
+    }
+
+    NTSTATUS NTAPI NtQuerySystemInformation(SYSTEM_INFORMATION_CLASS info_class,
+                                            PVOID                    buffer,
+                                            ULONG                    size,
+                                            PULONG                   returned)
+    {
+        if(info_class != SystemPoolTagInformation)
+            return STATUS_INVALID_INFO_CLASS;
+
+        const auto required = offsetof(SYSTEM_POOLTAG_INFORMATION, TagInfo) +
+                              tags.size() * sizeof(SYSTEM_POOLTAG);
+        if(returned)
+            *returned = static_cast<ULONG>(required);
+        if(size < required)
+            return STATUS_INFO_LENGTH_MISMATCH;
+
+        const auto info = static_cast<SYSTEM_POOLTAG_INFORMATION*>(buffer);
+        info->Count     = static_cast<ULONG>(tags.size());
+        std::memcpy(info->TagInfo, tags.data(), tags.size() * sizeof(SYSTEM_POOLTAG));
+        return STATUS_SUCCESS;
+    }
+
+} // namespace fake
+
+#include <ntw/sys/pool_tag_sampler.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+SYSTEM_POOLTAG& tag(std::uint32_t value)
+{
+    for(auto& t : fake::tags)
+        if(t.TagUlong == value)
+            return t;
+
+    auto& t    = fake::tags.emplace_back();
+    t.TagUlong = value;
+    return t;
+}
+
+TEST_CASE("pool_tag_sampler ranks tags by growth")
+{
+    fake::tags.clear();
+    for(std::uint32_t i = 0; i < 500; ++i)
+        tag(i).PagedUsed = 0x1000;
+
+    ntw::sys::pool_tag_sampler sampler(4);
+    REQUIRE(sampler.sample().success());
+
+    ntw::sys::pool_tag_growth top[3];
+    REQUIRE(sampler.top_used(ntw::sys::pool_type::paged, top) == 0);
+
+    tag(7).PagedUsed += 0x300;
+    tag(9).PagedUsed += 0x500;
+    tag(9).PagedAllocs += 10;
+    tag(9).PagedFrees += 4;
+    tag(11).NonPagedAllocs += 3;
+    tag(600).PagedUsed = 0x200;
+    REQUIRE(sampler.sample().success());
+    REQUIRE(sampler.tags() == 501);
+
+    REQUIRE(sampler.top_used(ntw::sys::pool_type::paged, top) == 3);
+    CHECK(top[0].tag == 9);
+    CHECK(top[0].used == 0x500);
+    CHECK(top[1].tag == 7);
+    CHECK(top[2].tag == 600);
+    CHECK(top[2].used == 0x200);
+
+    REQUIRE(sampler.top_outstanding(ntw::sys::pool_type::paged, top) == 3);
+    CHECK(top[0].tag == 9);
+    CHECK(top[0].outstanding == 6);
+
+    REQUIRE(sampler.top_outstanding(ntw::sys::pool_type::non_paged, top) == 3);
+    CHECK(top[0].tag == 11);
+    CHECK(top[0].outstanding == 3);
+}
+
+TEST_CASE("pool_tag_sampler windows over the ring")
+{
+    fake::tags.clear();
+    tag(1).PagedUsed = 100;
+    tag(2).PagedUsed = 100;
+
+    ntw::sys::pool_tag_sampler sampler(3);
+    REQUIRE(sampler.reserve(64).success());
+    const auto allocations = fake::allocations;
+
+    for(int i = 0; i < 10; ++i) {
+        // tag 1 grows slowly but steadily, tag 2 only in the last sample
+        tag(1).PagedUsed += 10;
+        if(i == 9)
+            tag(2).PagedUsed += 15;
+        REQUIRE(sampler.sample().success());
+    }
+    REQUIRE(sampler.samples() == 3);
+
+    ntw::sys::pool_tag_growth top[1];
+    REQUIRE(sampler.top_used(ntw::sys::pool_type::paged, top) == 1);
+    CHECK(top[0].tag == 1);
+    CHECK(top[0].used == 20);
+
+    REQUIRE(sampler.top_used(ntw::sys::pool_type::paged, top, 2) == 1);
+    CHECK(top[0].tag == 2);
+    CHECK(top[0].used == 15);
+
+    // only the first query buffer was allocated after reserve
+    REQUIRE(fake::allocations == allocations + 1);
+}
@@ -0,0 +1,97 @@
+#include <ntw/sys/process_columns.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+#include <vector>
+
+#pragma comment(lib, "ntdll.lib")
+
+// builds a SystemProcessInformation blob without threads where process i has
+// pid (i + 1) * 4, session i % 3 and a working set of i * 0x1000
+std::vector<std::uint8_t> make_blob(std::size_t count)
+{
+    std::vector<std::uint8_t> blob((count + 1) * sizeof(ntw::sys::process));
+    for(std::size_t i = 0; i <= count; ++i) {
+        const auto offset = i * sizeof(ntw::sys::process);
+        auto       p      = reinterpret_cast<ntw::sys::process*>(blob.data() + offset);
+        // the last entry terminates the list
+        p->offset_to_next     = i == count ? 0 : sizeof(ntw::sys::process);
+        p->id                 = (i + 1) * 4;
+        p->session_id         = static_cast<std::uint32_t>(i % 3);
+        p->handle_count       = static_cast<std::uint32_t>(i);
+        p->working_set_size   = i * 0x1000;
+        p->private_page_count = i;
+    }
+    return blob;
+}
+
+ntw::sys::process::range_type as_range(std::vector<std::uint8_t>& blob)
+{
+    return { reinterpret_cast<ntw::sys::process*>(blob.data()) };
+}
+
+TEST_CASE("process_columns copies the selected fields")
+{
+    auto blob = make_blob(3000);
+
+    ntw::sys::process_columns columns;
+    REQUIRE(columns
+                .assign(as_range(blob),
+                        ntw::sys::process_fields{}.id().session_id().working_set_size())
+                .success());
+    REQUIRE(columns.size() == 3000);
+    REQUIRE(columns.id().size() == 3000);
+    REQUIRE(columns.handle_count().empty());
+    REQUIRE(reinterpret_cast<std::uintptr_t>(columns.working_set_size().data()) % 64 ==
+            0);
+
+    for(std::size_t i = 0; i < columns.size(); ++i) {
+        CHECK(columns.id()[i] == (i + 1) * 4);
+        CHECK(columns.session_id()[i] == i % 3);
+        CHECK(columns.working_set_size()[i] == i * 0x1000);
+    }
+
+    // reassigning with other fields reuses the storage
+    REQUIRE(columns.assign(as_range(blob), ntw::sys::process_fields::all()).success());
+    REQUIRE(columns.handle_count()[2999] == 2999);
+    REQUIRE(columns.private_page_count()[1234] == 1234);
+}
+
+TEST_CASE("process_columns reductions")
+{
+    auto blob = make_blob(1001);
+
+    ntw::sys::process_columns columns;
+    REQUIRE(columns.assign(as_range(blob), ntw::sys::process_fields::all()).success());
+
+    std::uint64_t total = 0, session = 0;
+    for(std::uint64_t i = 0; i < 1001; ++i) {
+        total += i;
+        if(i % 3 == 1)
+            session += i;
+    }
+
+    REQUIRE(ntw::sys::sum(columns.private_page_count()) == total);
+    REQUIRE(ntw::sys::sum(columns.handle_count()) == total);
+    REQUIRE(ntw::sys::sum_where(columns.private_page_count(), columns.session_id(), 1) ==
+            session);
+    REQUIRE(ntw::sys::sum_where(columns.private_page_count(), columns.session_id(), 7) ==
+            0);
+}
+
+TEST_CASE("top_n orders by value and then by row")
+{
+    const std::vector<std::uint64_t> values = { 5, 9, 1, 9, 7, 3, 9, 0, 8 };
+
+    std::uint32_t out[4];
+    REQUIRE(ntw::sys::top_n(std::span<const std::uint64_t>(values), std::span(out)) == 4);
+    REQUIRE(out[0] == 1);
+    REQUIRE(out[1] == 3);
+    REQUIRE(out[2] == 6);
+    REQUIRE(out[3] == 8);
+
+    std::uint32_t all[16];
+    REQUIRE(ntw::sys::top_n(std::span<const std::uint64_t>(values), std::span(all)) ==
+            values.size());
+    REQUIRE(all[values.size() - 1] == 7);
+}
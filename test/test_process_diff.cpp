@@ -0,0 +1,141 @@
+#include <ntw/sys/process_diff.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+#include <vector>
+#include <algorithm>
+
+#pragma comment(lib, "ntdll.lib")
+
+struct fake_process {
+    std::uintptr_t             id;
+    std::uint64_t              create_time;
+    std::int64_t               kernel_time;
+    std::vector<std::uint64_t> thread_ids;
+};
+
+// builds a SystemProcessInformation blob where every thread is created at the same
+// time as its process
+std::vector<std::uint8_t> make_blob(const std::vector<fake_process>& processes)
+{
+    std::vector<std::uint8_t> blob;
+    for(std::size_t i = 0; i <= processes.size(); ++i) {
+        // the last entry terminates the list
+        const auto last    = i == processes.size();
+        const auto threads = last ? 0 : processes[i].thread_ids.size();
+        const auto offset  = blob.size();
+        const auto size =
+            sizeof(ntw::sys::process) + threads * sizeof(ntw::sys::thread);
+        blob.resize(offset + size);
+
+        auto p            = reinterpret_cast<ntw::sys::process*>(blob.data() + offset);
+        p->offset_to_next = last ? 0 : static_cast<std::uint32_t>(size);
+        p->thread_count   = static_cast<std::uint32_t>(threads);
+        if(last)
+            break;
+
+        p->id          = processes[i].id;
+        p->create_time = processes[i].create_time;
+        p->kernel_time = ntw::duration{ processes[i].kernel_time };
+        p->cycle_time  = processes[i].kernel_time * 3;
+
+        for(std::size_t j = 0; j < threads; ++j) {
+            auto& t            = p->threads()[j];
+            t.id               = processes[i].thread_ids[j];
+            t.process_id       = p->id;
+            t.create_time      = p->create_time;
+            t.context_switches = static_cast<std::uint32_t>(processes[i].kernel_time);
+        }
+    }
+    return blob;
+}
+
+ntw::sys::process::range_type as_range(std::vector<std::uint8_t>& blob)
+{
+    return { reinterpret_cast<ntw::sys::process*>(blob.data()) };
+}
+
+struct recorder {
+    std::vector<std::uintptr_t> created, exited, changed;
+    std::vector<std::uintptr_t> threads_created, threads_exited;
+    std::vector<std::int64_t>   kernel_deltas;
+    std::vector<std::uint64_t>  cycle_deltas;
+    std::vector<std::uint32_t>  switch_deltas;
+
+    void process_created(const ntw::sys::process& p) { created.push_back(p.id); }
+
+    void process_exited(const ntw::sys::process& p) { exited.push_back(p.id); }
+
+    void process_changed(const ntw::sys::process&       prev,
+                         const ntw::sys::process&       curr,
+                         const ntw::sys::process_delta& d)
+    {
+        changed.push_back(curr.id);
+        kernel_deltas.push_back(d.kernel_time.count());
+        cycle_deltas.push_back(d.cycle_time);
+    }
+
+    void thread_created(const ntw::sys::process&, const ntw::sys::thread& t)
+    {
+        threads_created.push_back(t.id);
+    }
+
+    void thread_exited(const ntw::sys::process&, const ntw::sys::thread& t)
+    {
+        threads_exited.push_back(t.id);
+    }
+
+    void thread_changed(const ntw::sys::process&,
+                        const ntw::sys::thread&,
+                        const ntw::sys::thread&       curr,
+                        const ntw::sys::thread_delta& d)
+    {
+        switch_deltas.push_back(d.context_switches);
+    }
+};
+
+TEST_CASE("process_differ reports created, exited and changed processes")
+{
+    auto prev = make_blob({ { 4, 1, 10, { 8, 12 } },
+                            { 16, 1, 20, { 20 } },
+                            // pid reuse must not be mistaken for the old process
+                            { 24, 1, 30, { 28 } } });
+    auto curr = make_blob({ { 4, 1, 15, { 8, 32 } },
+                            { 24, 2, 0, { 36 } },
+                            { 40, 3, 0, { 44, 48 } } });
+
+    ntw::sys::process_differ differ;
+    recorder                 r;
+    REQUIRE(differ.diff(as_range(prev), as_range(curr), r).success());
+
+    REQUIRE(r.changed == std::vector<std::uintptr_t>{ 4 });
+    REQUIRE(r.kernel_deltas == std::vector<std::int64_t>{ 5 });
+    REQUIRE(r.cycle_deltas == std::vector<std::uint64_t>{ 15 });
+    REQUIRE(r.created == std::vector<std::uintptr_t>{ 24, 40 });
+    REQUIRE(r.exited.size() == 2);
+    CHECK(std::count(r.exited.begin(), r.exited.end(), 16) == 1);
+    CHECK(std::count(r.exited.begin(), r.exited.end(), 24) == 1);
+
+    REQUIRE(r.switch_deltas == std::vector<std::uint32_t>{ 5 });
+    REQUIRE(r.threads_created == std::vector<std::uintptr_t>{ 32, 36, 44, 48 });
+    REQUIRE(r.threads_exited.size() == 3);
+}
+
+TEST_CASE("process_differ visitor may handle a subset of events")
+{
+    auto prev = make_blob({ { 4, 1, 10, { 8 } } });
+    auto curr = make_blob({ { 4, 1, 10, { 8 } }, { 12, 2, 0, {} } });
+
+    struct {
+        int  created = 0;
+        void process_created(const ntw::sys::process&) { ++created; }
+    } visitor;
+
+    ntw::sys::process_differ differ;
+    REQUIRE(differ.diff(as_range(prev), as_range(curr), visitor).success());
+    REQUIRE(visitor.created == 1);
+
+    // the second diff reuses the tables
+    REQUIRE(differ.diff(as_range(curr), as_range(prev), visitor).success());
+    REQUIRE(visitor.created == 1);
+}
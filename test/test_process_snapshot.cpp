@@ -0,0 +1,143 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace fake {
+
+    using ::NtAllocateVirtualMemoryEx;
+    using ::NtClose;
+    using ::NtDelayExecution;
+    using ::NtUnmapViewOfSection;
+
+    std::size_t               allocations = 0, queries = 0;
+    std::vector<std::uint8_t> blob;
+    bool                      understate = false; // report less than is required
+
+    NTSTATUS NTAPI NtAllocateVirtualMemory(
+        HANDLE, PVOID* base, ULONG_PTR, PSIZE_T size, ULONG, ULONG)
+    {
+        ++allocations;
+        *base = std::calloc(*size, 1);
+        return *base ? STATUS_SUCCESS : STATUS_NO_MEMORY;
+    }
+
+    NTSTATUS NTAPI NtFreeVirtualMemory(HANDLE, PVOID* base, PSIZE_T, ULONG)
+    {
+        std::free(*base);
+        return STATUS_SUCCESS;
+    }
+
+    NTSTATUS NTAPI NtQuerySystemInformation(SYSTEM_INFORMATION_CLASS info_class,
+                                            PVOID                    buffer,
+                                            ULONG                    size,
+                                            PULONG                   returned)
+    {
+        if(info_class != SystemProcessInformation)
+            return STATUS_INVALID_INFO_CLASS;
+
+        // keeps a caller that never grows the buffer from looping forever
+        if(++queries > 1000)
+            return STATUS_UNSUCCESSFUL;
+
+        const auto fits = size >= blob.size();
+        if(returned)
+            *returned = static_cast<ULONG>(understate && !fits ? size / 2 : blob.size());
+        if(!fits)
+            return STATUS_INFO_LENGTH_MISMATCH;
+
+        std::memcpy(buffer, blob.data(), blob.size());
+        return STATUS_SUCCESS;
+    }
+
+} // namespace fake
+
+#include <ntw/sys/process_snapshot.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+// builds a SystemProcessInformation blob with the given amount of processes where
+// each process has pid * 4 and has pid threads
+void make_blob(std::size_t count)
+{
+    fake::blob.clear();
+    fake::queries = 0;
+    for(std::size_t i = 1; i <= count + 1; ++i) {
+        const auto offset = fake::blob.size();
+        const auto size   = sizeof(ntw::sys::process) + i * sizeof(ntw::sys::thread);
+        fake::blob.resize(offset + size);
+
+        auto p          = reinterpret_cast<ntw::sys::process*>(fake::blob.data() + offset);
+        p->id           = i * 4;
+        p->thread_count = static_cast<std::uint32_t>(i);
+        // the last entry terminates the list
+        p->offset_to_next = i == count + 1 ? 0 : static_cast<std::uint32_t>(size);
+        for(auto& t : p->threads()) {
+            t.process_id = p->id;
+            t.id         = p->id + 1;
+        }
+    }
+}
+
+TEST_CASE("process_snapshot grows until the processes fit")
+{
+    make_blob(2000);
+
+    ntw::sys::process_snapshot snapshot;
+    REQUIRE(snapshot.empty());
+    REQUIRE(snapshot.refresh().success());
+    REQUIRE(snapshot.capacity() >= fake::blob.size());
+    REQUIRE(snapshot.used() == fake::blob.size());
+
+    std::size_t count = 0;
+    for(auto& p : snapshot) {
+        ++count;
+        CHECK(p.id == count * 4);
+        CHECK(p.threads().size() == count);
+    }
+    REQUIRE(count == 2000);
+}
+
+TEST_CASE("process_snapshot does not allocate in the steady state")
+{
+    make_blob(500);
+
+    ntw::sys::process_snapshot snapshot;
+    REQUIRE(snapshot.refresh().success());
+
+    const auto allocations = fake::allocations;
+    const auto capacity    = snapshot.capacity();
+    for(int i = 0; i < 16; ++i)
+        REQUIRE(snapshot.refresh().success());
+
+    REQUIRE(fake::allocations == allocations);
+    REQUIRE(snapshot.capacity() == capacity);
+}
+
+TEST_CASE("process_snapshot respects reserve")
+{
+    make_blob(10);
+
+    ntw::sys::process_snapshot snapshot;
+    REQUIRE(snapshot.reserve(0x100000).success());
+
+    const auto allocations = fake::allocations;
+    REQUIRE(snapshot.refresh().success());
+    REQUIRE(fake::allocations == allocations);
+    REQUIRE(snapshot.capacity() == 0x100000);
+}
+
+TEST_CASE("process_snapshot grows when the reported size is too small")
+{
+    make_blob(2000);
+    fake::understate = true;
+
+    ntw::sys::process_snapshot snapshot;
+    const auto                 s = snapshot.refresh();
+    fake::understate             = false;
+
+    REQUIRE(s.success());
+    REQUIRE(snapshot.used() == fake::blob.size());
+}
@@ -19,4 +19,40 @@ TEST_CASE("acquire_processes works")
         for(auto& t : p.threads())
             CHECK(t.id != 0);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("acquire_extended_processes works")
+{
+    std::vector<std::uint8_t> arr(0x200000);
+    auto                      processes = ntw::sys::extended_processes(arr);
+    REQUIRE(processes);
+    for(auto& p : *processes) {
+        if(p.id == 0)
+            continue;
+
+        INFO(p.id);
+        for(auto& t : p.threads()) {
+            CHECK(t.id != 0);
+            CHECK(t.stack_base != nullptr);
+        }
+    }
+}
+
+TEST_CASE("acquire_full_processes works")
+{
+    std::vector<std::uint8_t> arr(0x200000);
+    auto                      processes = ntw::sys::full_processes(arr);
+    REQUIRE(processes);
+    for(auto& p : *processes) {
+        if(p.id == 0 || p.id == 4)
+            continue;
+
+        INFO(p.id);
+        CHECK(p.user_sid() != nullptr);
+        // the extension also counts context switches of threads that already exited
+        std::uint64_t switches = 0;
+        for(auto& t : p.threads())
+            switches += t.context_switches;
+        CHECK(p.extension().context_switches >= switches);
+    }
+}
@@ -0,0 +1,175 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <map>
+
+namespace fake {
+
+    // two adjacent allocations of 16 pages each
+    constexpr std::uintptr_t       base = 0x10000, allocation_size = 0x10000;
+    std::map<std::uintptr_t, ULONG> pages;
+    std::size_t                     calls = 0;
+
+    void reset()
+    {
+        calls = 0;
+        pages.clear();
+        for(auto p = base; p < base + 2 * allocation_size; p += 0x1000)
+            pages[p] = PAGE_READONLY;
+    }
+
+    NTSTATUS NTAPI NtProtectVirtualMemory(
+        HANDLE, PVOID* address, PSIZE_T size, ULONG prot, PULONG old)
+    {
+        ++calls;
+        const auto begin = reinterpret_cast<std::uintptr_t>(*address) & ~0xFFFull;
+        const auto end   = (reinterpret_cast<std::uintptr_t>(*address) + *size + 0xFFF) &
+                         ~0xFFFull;
+        if(begin < base || end > base + 2 * allocation_size || begin == end)
+            return STATUS_INVALID_PARAMETER;
+        if((begin - base) / allocation_size != (end - 1 - base) / allocation_size)
+            return STATUS_CONFLICTING_ADDRESSES;
+
+        *old = pages[begin];
+        for(auto p = begin; p < end; p += 0x1000)
+            pages[p] = prot;
+        *address = reinterpret_cast<void*>(begin);
+        *size    = end - begin;
+        return STATUS_SUCCESS;
+    }
+
+    // regions are runs of pages with the same protection within an allocation
+    NTSTATUS NTAPI NtQueryVirtualMemory(HANDLE,
+                                        PVOID address,
+                                        MEMORY_INFORMATION_CLASS,
+                                        PVOID info,
+                                        SIZE_T,
+                                        PSIZE_T)
+    {
+        const auto page = reinterpret_cast<std::uintptr_t>(address) & ~0xFFFull;
+        if(page < base || page >= base + 2 * allocation_size)
+            return STATUS_INVALID_PARAMETER;
+
+        const auto first = base + (page - base) / allocation_size * allocation_size;
+        auto       begin = page, end = page + 0x1000;
+        while(begin > first && pages[begin - 0x1000] == pages[page])
+            begin -= 0x1000;
+        while(end < first + allocation_size && pages[end] == pages[page])
+            end += 0x1000;
+
+        auto& mbi       = *static_cast<MEMORY_BASIC_INFORMATION*>(info);
+        mbi.BaseAddress = reinterpret_cast<void*>(begin);
+        mbi.RegionSize  = end - begin;
+        mbi.Protect     = pages[page];
+        return STATUS_SUCCESS;
+    }
+
+} // namespace fake
+
+#include <ntw/vm/protect.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+TEST_CASE("protect returns the old protection")
+{
+    fake::reset();
+
+    const auto old = ntw::vm::protect(0x10800, 0x1000, ntw::vm::protection::read_write());
+    REQUIRE(old.success());
+    REQUIRE(old->get() == PAGE_READONLY);
+    REQUIRE(fake::pages[0x10000] == PAGE_READWRITE);
+    REQUIRE(fake::pages[0x11000] == PAGE_READWRITE);
+    REQUIRE(fake::pages[0x12000] == PAGE_READONLY);
+
+    REQUIRE(ntw::vm::protect(0x1000, 1, ntw::vm::protection::read()) ==
+            STATUS_INVALID_PARAMETER);
+}
+
+TEST_CASE("scoped_protection restores on scope exit")
+{
+    fake::reset();
+    {
+        ntw::vm::scoped_protection writable(
+            0x12000, 0x2000, ntw::vm::protection::read_write());
+        REQUIRE(writable.status().success());
+        REQUIRE(writable.old().get() == PAGE_READONLY);
+        REQUIRE(fake::pages[0x13000] == PAGE_READWRITE);
+
+        auto moved = std::move(writable);
+        REQUIRE(fake::calls == 1);
+    }
+    REQUIRE(fake::pages[0x12000] == PAGE_READONLY);
+    REQUIRE(fake::pages[0x13000] == PAGE_READONLY);
+    REQUIRE(fake::calls == 2);
+
+    {
+        ntw::vm::scoped_protection kept(0x12000, 0x1000, ntw::vm::protection::execute());
+        kept.release();
+    }
+    REQUIRE(fake::pages[0x12000] == PAGE_EXECUTE);
+
+    {
+        ntw::vm::scoped_protection failed(0x1000, 0x1000, ntw::vm::protection::read());
+        REQUIRE(failed.status() == STATUS_INVALID_PARAMETER);
+    }
+    REQUIRE(fake::calls == 3);
+}
+
+TEST_CASE("scoped_protection rejects ranges with several protections")
+{
+    fake::reset();
+    fake::pages[0x13000] = PAGE_EXECUTE_READ;
+    {
+        ntw::vm::scoped_protection writable(
+            0x12800, 0x1000, ntw::vm::protection::read_write());
+        REQUIRE(writable.status() == STATUS_CONFLICTING_ADDRESSES);
+    }
+    REQUIRE(fake::calls == 0);
+    REQUIRE(fake::pages[0x12000] == PAGE_READONLY);
+    REQUIRE(fake::pages[0x13000] == PAGE_EXECUTE_READ);
+
+    {
+        ntw::vm::scoped_protection writable(
+            0x13000, 0x1000, ntw::vm::protection::read_write());
+        REQUIRE(writable.status().success());
+        REQUIRE(writable.old().get() == PAGE_EXECUTE_READ);
+    }
+    REQUIRE(fake::pages[0x13000] == PAGE_EXECUTE_READ);
+}
+
+TEST_CASE("protect merges sorted ranges")
+{
+    fake::reset();
+
+    // the first four touch or overlap, the fifth is a page apart
+    ntw::vm::range ranges[] = { { reinterpret_cast<void*>(0x13000), 0x10 },
+                                { reinterpret_cast<void*>(0x10000), 0x1000 },
+                                { reinterpret_cast<void*>(0x11800), 0x100 },
+                                { reinterpret_cast<void*>(0x12FF0), 0x20 },
+                                { reinterpret_cast<void*>(0x15000), 0x1000 },
+                                { reinterpret_cast<void*>(0x16000), 0 } };
+
+    REQUIRE(ntw::vm::protect(ranges, ntw::vm::protection::read_execute()).success());
+    REQUIRE(fake::calls == 2);
+    REQUIRE(ranges[0].address == reinterpret_cast<void*>(0x10000));
+    for(auto p = 0x10000; p < 0x14000; p += 0x1000)
+        REQUIRE(fake::pages[p] == PAGE_EXECUTE_READ);
+    REQUIRE(fake::pages[0x14000] == PAGE_READONLY);
+    REQUIRE(fake::pages[0x15000] == PAGE_EXECUTE_READ);
+    REQUIRE(fake::pages[0x16000] == PAGE_READONLY);
+}
+
+TEST_CASE("protect retries ranges spanning allocations one by one")
+{
+    fake::reset();
+
+    ntw::vm::range ranges[] = { { reinterpret_cast<void*>(0x1F000), 0x1000 },
+                                { reinterpret_cast<void*>(0x20000), 0x1000 },
+                                { reinterpret_cast<void*>(0x40000), 0x1000 } };
+
+    REQUIRE(ntw::vm::protect(ranges, ntw::vm::protection::read_write()) ==
+            STATUS_INVALID_PARAMETER);
+    REQUIRE(fake::calls == 4);
+    REQUIRE(fake::pages[0x1F000] == PAGE_READWRITE);
+    REQUIRE(fake::pages[0x20000] == PAGE_READWRITE);
+}
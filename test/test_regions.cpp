@@ -0,0 +1,105 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <vector>
+
+namespace fake {
+
+    using ::NtAllocateVirtualMemory;
+    using ::NtClose;
+    using ::NtFreeVirtualMemory;
+
+    std::vector<MEMORY_BASIC_INFORMATION> regions;
+    std::size_t                           queries = 0;
+
+    NTSTATUS NTAPI NtQueryVirtualMemory(HANDLE,
+                                        PVOID                    address,
+                                        MEMORY_INFORMATION_CLASS info_class,
+                                        PVOID                    buffer,
+                                        SIZE_T                   size,
+                                        PSIZE_T)
+    {
+        ++queries;
+        if(info_class != MemoryBasicInformation)
+            return STATUS_INVALID_INFO_CLASS;
+
+        const auto a = reinterpret_cast<std::uintptr_t>(address);
+        for(const auto& r : regions) {
+            const auto base = reinterpret_cast<std::uintptr_t>(r.BaseAddress);
+            if(a >= base && a < base + r.RegionSize) {
+                *static_cast<MEMORY_BASIC_INFORMATION*>(buffer) = r;
+                return STATUS_SUCCESS;
+            }
+        }
+        return STATUS_INVALID_PARAMETER;
+    }
+
+    void add(std::uintptr_t base, SIZE_T size, ULONG state, ULONG protect, ULONG type)
+    {
+        auto& r       = regions.emplace_back();
+        r.BaseAddress = reinterpret_cast<void*>(base);
+        r.RegionSize  = size;
+        r.State       = state;
+        r.Protect     = protect;
+        r.Type        = type;
+    }
+
+} // namespace fake
+
+#include <ntw/vm/regions.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+void make_regions()
+{
+    fake::regions.clear();
+    fake::add(0x00000, 0x10000, MEM_FREE, PAGE_NOACCESS, 0);
+    fake::add(0x10000, 0x1000, MEM_COMMIT, PAGE_READWRITE, MEM_PRIVATE);
+    fake::add(0x11000, 0x2000, MEM_COMMIT, PAGE_READWRITE, MEM_PRIVATE);
+    fake::add(0x13000, 0x1000, MEM_COMMIT, PAGE_READONLY, MEM_PRIVATE);
+    fake::add(0x14000, 0x4000, MEM_RESERVE, 0, MEM_PRIVATE);
+    fake::add(0x18000, 0x1000, MEM_COMMIT, PAGE_READONLY, MEM_IMAGE);
+    fake::add(0x19000, 0x1000, MEM_COMMIT, PAGE_READONLY, MEM_IMAGE);
+}
+
+TEST_CASE("regions walks every region")
+{
+    make_regions();
+
+    std::vector<std::uintptr_t> bases;
+    auto                        range = ntw::vm::regions();
+    for(const auto& r : range)
+        bases.push_back(r.base);
+
+    REQUIRE(range.status().success());
+    REQUIRE(bases ==
+            std::vector<std::uintptr_t>{
+                0x00000, 0x10000, 0x11000, 0x13000, 0x14000, 0x18000, 0x19000 });
+}
+
+TEST_CASE("regions coalesces and filters")
+{
+    make_regions();
+
+    std::vector<std::pair<std::uintptr_t, std::size_t>> found;
+    for(const auto& r : ntw::vm::regions().coalesced().where(
+            [](const ntw::memory::basic_info& r) { return r.is_commited(); }))
+        found.emplace_back(r.base, r.size);
+
+    REQUIRE(found == std::vector<std::pair<std::uintptr_t, std::size_t>>{
+                         { 0x10000, 0x3000 }, { 0x13000, 0x1000 }, { 0x18000, 0x2000 } });
+}
+
+TEST_CASE("regions respects bounds")
+{
+    make_regions();
+
+    fake::queries = 0;
+    std::vector<std::uintptr_t> bases;
+    for(const auto& r : ntw::vm::regions().from(0x11800).until(0x14000))
+        bases.push_back(r.base);
+
+    REQUIRE(bases == std::vector<std::uintptr_t>{ 0x11000, 0x13000 });
+    // the walk stops without querying past the bound
+    REQUIRE(fake::queries == 2);
+}
@@ -0,0 +1,151 @@
+#include <ntw/vm/ring_buffer.hpp>
+#include <ntw/info/memory.hpp>
+#include <ntw/ob/process.hpp>
+#include <thread>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+#pragma comment(lib, "ntdll.lib")
+
+TEST_CASE("placeholders are split and replaced")
+{
+    const auto placeholder = ntw::vm::allocate().reserve_placeholder().reserve(
+        0x20000, ntw::vm::protection::no_access());
+    REQUIRE(placeholder.success());
+
+    const auto base = static_cast<std::uint8_t*>(*placeholder);
+    REQUIRE(ntw::vm::split_placeholder(base, 0x10000).success());
+
+    const auto second = ntw::vm::allocate()
+                            .at(base + 0x10000)
+                            .replace_placeholder()
+                            .commit_reserve(0x10000);
+    REQUIRE(second.success());
+    REQUIRE(*second == base + 0x10000);
+    base[0x10000] = 1;
+
+    REQUIRE(ntw::vm::release(base + 0x10000).success());
+    REQUIRE(ntw::vm::release(base).success());
+}
+
+TEST_CASE("ring_buffer views mirror each other")
+{
+    ntw::vm::ring_buffer ring;
+    REQUIRE(ring.write_area(1).empty());
+    REQUIRE(ring.read_area().empty());
+
+    REQUIRE(ring.create(1).success());
+    REQUIRE(ring.capacity() == ntw::vm::ring_buffer::granularity);
+    REQUIRE(ring.create(0x30000).success());
+    REQUIRE(ring.capacity() == 0x40000);
+
+    const auto data = ring.data();
+    data[0]         = 1;
+    REQUIRE(data[ring.capacity()] == 1);
+    data[2 * ring.capacity() - 1] = 2;
+    REQUIRE(data[ring.capacity() - 1] == 2);
+}
+
+TEST_CASE("ring_buffer unmaps its views")
+{
+    const auto is_free = [](const std::uint8_t* address) {
+        const auto info =
+            ntw::ob::process_ref{}.query_mem<ntw::memory::basic_info>(address);
+        return info.success() && info->is_free();
+    };
+
+    std::uint8_t* second;
+    {
+        ntw::vm::ring_buffer ring;
+        REQUIRE(ring.create(0x10000).success());
+        const auto first = ring.data();
+
+        // creating the buffer again destroys the previous one
+        REQUIRE(ring.create(0x20000).success());
+        second = ring.data();
+        for(const auto view : { first, first + 0x10000 }) {
+            const auto reused = view >= second && view < second + 0x40000;
+            REQUIRE((reused || is_free(view)));
+        }
+    }
+
+    REQUIRE(is_free(second));
+    REQUIRE(is_free(second + 0x20000));
+}
+
+TEST_CASE("ring_buffer records stay contiguous across the wrap point")
+{
+    ntw::vm::ring_buffer ring;
+    REQUIRE(ring.create(0x10000).success());
+
+    std::uint8_t record[1000];
+    for(std::size_t i = 0; i < 1000; ++i) {
+        for(std::size_t j = 0; j < sizeof(record); ++j)
+            record[j] = static_cast<std::uint8_t>(i + j);
+        REQUIRE(ring.write(record, sizeof(record)));
+
+        const auto data = ring.read_area();
+        REQUIRE(data.size() == sizeof(record));
+        REQUIRE(std::memcmp(data.data(), record, sizeof(record)) == 0);
+        ring.consume(data.size());
+    }
+
+    // fills up exactly
+    REQUIRE(ring.write_area(ring.capacity()).size() == ring.capacity());
+    ring.produce(ring.capacity());
+    REQUIRE(ring.size() == ring.capacity());
+    REQUIRE_FALSE(ring.write(record, 1));
+
+    REQUIRE(ring.read(record, sizeof(record)));
+    REQUIRE(ring.write(record, sizeof(record)));
+    REQUIRE_FALSE(ring.write(record, 1));
+}
+
+TEST_CASE("ring_buffer between two threads")
+{
+    ntw::vm::ring_buffer ring;
+    REQUIRE(ring.create(0x10000).success());
+
+    constexpr std::uint32_t count = 1000000;
+
+    std::thread producer([&] {
+        for(std::uint32_t i = 0; i < count;) {
+            // records of varying size made of repeated sequence numbers
+            const auto size = static_cast<std::size_t>(i % 7 + 1) * sizeof(i);
+            if(const auto area = ring.write_area(size); !area.empty()) {
+                for(std::size_t j = 0; j < size; j += sizeof(i))
+                    std::memcpy(area.data() + j, &i, sizeof(i));
+                ring.produce(size);
+                ++i;
+            }
+        }
+    });
+
+    bool          ordered = true;
+    std::uint32_t next    = 0;
+    while(next < count) {
+        const auto data = ring.read_area();
+
+        std::size_t offset = 0;
+        while(next < count) {
+            const auto size = static_cast<std::size_t>(next % 7 + 1) * sizeof(next);
+            if(data.size() - offset < size)
+                break;
+
+            for(std::size_t j = 0; j < size; j += sizeof(next)) {
+                std::uint32_t value;
+                std::memcpy(&value, data.data() + offset + j, sizeof(value));
+                ordered &= value == next;
+            }
+
+            offset += size;
+            ++next;
+        }
+        ring.consume(offset);
+    }
+
+    producer.join();
+    REQUIRE(ordered);
+    REQUIRE(ring.size() == 0);
+}
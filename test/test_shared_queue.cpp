@@ -0,0 +1,173 @@
+#include <ntw/vm/shared_queue.hpp>
+#include <ntw/ob/process.hpp>
+#include <string_view>
+#include <thread>
+#include <vector>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+#pragma comment(lib, "ntdll.lib")
+
+TEST_CASE("section views share memory")
+{
+    const auto section = ntw::ob::section::create(0x20000);
+    REQUIRE(section.success());
+
+    auto first = section->map();
+    REQUIRE(first.success());
+    REQUIRE(first->size() == 0x20000);
+
+    // the offset has to be a multiple of the allocation granularity
+    auto second = section->map(0x1000, 0x10000);
+    REQUIRE(second.success());
+    REQUIRE(second->size() == 0x1000);
+
+    first->data()[0x10010] = 0xAB;
+    REQUIRE(second->data()[0x10] == 0xAB);
+
+    ntw::ob::section_view moved = std::move(*second);
+    REQUIRE_FALSE(*second);
+    REQUIRE(moved.span()[0x10] == 0xAB);
+    REQUIRE(moved.unmap().success());
+    REQUIRE_FALSE(moved);
+
+    const auto address = first->release();
+    REQUIRE(first->data() == nullptr);
+    REQUIRE(ntw::vm::unmap(address).success());
+}
+
+TEST_CASE("events are set and cleared")
+{
+    const auto sync = ntw::ob::event::create(SynchronizationEvent, true);
+    REQUIRE(sync.success());
+    REQUIRE(sync->wait_for(ntw::duration{ 0 }) == STATUS_SUCCESS);
+    REQUIRE(sync->wait_for(ntw::duration{ 0 }) == STATUS_TIMEOUT);
+
+    const auto notification = ntw::ob::event::create(NotificationEvent);
+    REQUIRE(notification.success());
+    REQUIRE(notification->set().success());
+    REQUIRE(notification->wait_for(ntw::duration{ 0 }) == STATUS_SUCCESS);
+    REQUIRE(notification->wait_for(ntw::duration{ 0 }) == STATUS_SUCCESS);
+    REQUIRE(notification->clear().success());
+    REQUIRE(notification->wait_for(ntw::duration{ 0 }) == STATUS_TIMEOUT);
+}
+
+TEST_CASE("shared_queue records wrap around")
+{
+    ntw::vm::shared_queue queue;
+    REQUIRE(queue.front() == STATUS_NO_MORE_ENTRIES);
+    REQUIRE_FALSE(queue.try_push("", 0));
+
+    REQUIRE(queue.create(1).success());
+    REQUIRE(queue.capacity() == 0x1000);
+    REQUIRE(queue.max_message_size() == 0x800 - 8);
+    REQUIRE(queue.front() == STATUS_NO_MORE_ENTRIES);
+
+    std::uint8_t message[0x800] = {};
+    REQUIRE(queue.push(message, sizeof(message)) == STATUS_INVALID_PARAMETER);
+
+    for(std::size_t i = 0; i < 1000; ++i) {
+        // sizes that don't divide the capacity move records to the start
+        const auto size = (i * 37) % 300;
+        for(std::size_t j = 0; j < size; ++j)
+            message[j] = static_cast<std::uint8_t>(i + j);
+        REQUIRE(queue.try_push(message, size));
+
+        const auto data = queue.front();
+        REQUIRE(data.success());
+        REQUIRE(data->size() == size);
+        REQUIRE(std::memcmp(data->data(), message, size) == 0);
+        queue.pop();
+        REQUIRE(queue.size() == 0);
+    }
+
+    // records of 112 bytes leave 64 unused bytes at the end
+    REQUIRE(queue.create(0x1000).success());
+    std::size_t pushed = 0;
+    while(queue.try_push(message, 100))
+        ++pushed;
+    REQUIRE(pushed == 36);
+    REQUIRE(queue.size() == 36 * 112);
+
+    queue.pop();
+    REQUIRE(queue.try_push(message, 100));
+    REQUIRE(queue.size() == 0x1000);
+    REQUIRE_FALSE(queue.try_push(message, 0));
+}
+
+TEST_CASE("shared_queue attached through duplicated handles")
+{
+    ntw::vm::shared_queue producer;
+    REQUIRE(producer.create(0x10000).success());
+
+    const ntw::ob::process_ref process;
+    auto section   = process.duplicate_object<ntw::ob::section>(producer.section());
+    auto not_empty = process.duplicate_object<ntw::ob::event>(producer.not_empty_event());
+    auto not_full  = process.duplicate_object<ntw::ob::event>(producer.not_full_event());
+    REQUIRE(section.success());
+    REQUIRE(not_empty.success());
+    REQUIRE(not_full.success());
+
+    ntw::vm::shared_queue consumer;
+    REQUIRE(consumer
+                .attach(std::move(*section), std::move(*not_empty), std::move(*not_full))
+                .success());
+    REQUIRE(consumer.capacity() == 0x10000);
+
+    REQUIRE(producer.try_push("hello", 5));
+    const auto data = consumer.front();
+    REQUIRE(data.success());
+    REQUIRE(std::string_view(reinterpret_cast<const char*>(data->data()), 5) == "hello");
+    consumer.pop();
+    REQUIRE(producer.size() == 0);
+
+    // a section that was not set up as a queue
+    auto other = ntw::ob::section::create(0x10000);
+    REQUIRE(other.success());
+    auto events = ntw::ob::event::create();
+    REQUIRE(consumer.attach(std::move(*other), std::move(*events), {}) ==
+            STATUS_INVALID_PARAMETER);
+}
+
+TEST_CASE("shared_queue with blocked producers and consumer")
+{
+    ntw::vm::shared_queue queue;
+    REQUIRE(queue.create(0x1000).success());
+
+    constexpr std::uint32_t count = 200000;
+
+    std::atomic<bool>        pushed = true;
+    std::vector<std::thread> producers;
+    for(std::uint32_t id = 0; id < 2; ++id) {
+        producers.emplace_back([&, id] {
+            std::uint32_t message[16];
+            for(std::uint32_t i = 0; i < count; ++i) {
+                message[0] = id;
+                message[1] = i;
+                const auto size = (i % 15 + 2) * sizeof(std::uint32_t);
+                if(!queue.push(message, size).success())
+                    pushed = false;
+            }
+        });
+    }
+
+    bool          ordered = true;
+    std::uint32_t next[2] = {};
+    for(std::uint32_t received = 0; received < 2 * count; ++received) {
+        const auto data = queue.wait_front();
+        REQUIRE(data.success());
+
+        std::uint32_t header[2];
+        std::memcpy(header, data->data(), sizeof(header));
+        ordered &= header[0] < 2 && header[1] == next[header[0]]++;
+        ordered &= data->size() == (header[1] % 15 + 2) * sizeof(std::uint32_t);
+        queue.pop();
+    }
+
+    for(auto& producer : producers)
+        producer.join();
+    REQUIRE(pushed);
+    REQUIRE(ordered);
+    REQUIRE(queue.size() == 0);
+}
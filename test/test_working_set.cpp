@@ -0,0 +1,97 @@
+#define NTW_SYSCALL(fn) fake::fn
+#include <ntw/detail/common.hpp>
+#include <vector>
+
+namespace fake {
+
+    using ::NtAllocateVirtualMemory;
+    using ::NtAllocateVirtualMemoryEx;
+    using ::NtFreeVirtualMemory;
+    using ::NtUnmapViewOfSection;
+
+    std::size_t calls = 0;
+
+    // pages with an odd number are resident, every third is shared and every fifth
+    // resident one is locked. the node is the page number modulo 4
+    NTSTATUS NTAPI NtQueryVirtualMemory(HANDLE,
+                                        PVOID                    address,
+                                        MEMORY_INFORMATION_CLASS info_class,
+                                        PVOID                    buffer,
+                                        SIZE_T                   length,
+                                        PSIZE_T)
+    {
+        ++calls;
+        if(address || info_class != MemoryWorkingSetExInformation)
+            return STATUS_INVALID_PARAMETER;
+
+        const auto entries = static_cast<MEMORY_WORKING_SET_EX_INFORMATION*>(buffer);
+        for(SIZE_T i = 0; i < length / sizeof(*entries); ++i) {
+            const auto page =
+                reinterpret_cast<std::uintptr_t>(entries[i].VirtualAddress) >> 12;
+
+            auto& a  = entries[i].VirtualAttributes;
+            a.Flags  = 0;
+            a.Valid  = page % 2;
+            a.Shared = page % 3 == 0;
+            if(a.Valid) {
+                a.Locked = page % 5 == 0;
+                a.Node   = page % 4;
+            }
+        }
+        return STATUS_SUCCESS;
+    }
+
+} // namespace fake
+
+#include <ntw/vm/working_set.hpp>
+#define CATCH_CONFIG_MAIN
+#define WIN32_NO_STATUS
+#include <catch2/catch.hpp>
+
+TEST_CASE("residency_map over a region")
+{
+    fake::calls = 0;
+
+    ntw::vm::residency_map map;
+    REQUIRE(map.query(0x10800, 0x82000).success());
+    REQUIRE(fake::calls == 1);
+    REQUIRE(map.size() == 0x83);
+    REQUIRE(map.resident_bits().size() == 3);
+    REQUIRE(map.entries()[0].virtual_address == 0x10000);
+
+    std::size_t resident = 0;
+    for(std::size_t i = 0; i < map.size(); ++i) {
+        const auto page = 0x10 + i;
+        REQUIRE(map.resident(i) == (page % 2 == 1));
+        REQUIRE(map.shared(i) == (page % 3 == 0));
+        REQUIRE(map.locked(i) == (page % 2 == 1 && page % 5 == 0));
+        REQUIRE(map.node(i) == (page % 2 ? page % 4 : 0));
+        resident += page % 2;
+    }
+    REQUIRE(map.resident_count() == resident);
+
+    // bits past the last page stay clear
+    REQUIRE(map.resident_bits()[2] >> 3 == 0);
+}
+
+TEST_CASE("residency_map over a list of addresses")
+{
+    fake::calls = 0;
+
+    const std::uintptr_t addresses[] = { 0x5123, 0xA000, 0xF000 };
+
+    ntw::vm::residency_map map;
+    REQUIRE(map.query(addresses).success());
+    REQUIRE(fake::calls == 1);
+    REQUIRE(map.size() == 3);
+    REQUIRE(map.resident_bits()[0] == 0b101);
+    REQUIRE(map.shared_bits()[0] == 0b100);
+    REQUIRE(map.locked_bits()[0] == 0b101);
+    REQUIRE(map.nodes()[0] == 1);
+    REQUIRE(map.nodes()[2] == 3);
+
+    REQUIRE(map.query(std::span<const std::uintptr_t>{}).success());
+    REQUIRE(map.size() == 0);
+    REQUIRE(map.resident_count() == 0);
+    REQUIRE(fake::calls == 1);
+}